@@ -147,28 +147,39 @@ Local<Object> HermesEngine::createConstructor(const internal::ClassDefineState*
         scriptClass->internalState_.scriptEngine_ = engine;
         scriptClass->internalState_.classDefine = classDefine;
         scriptClass->internalState_.polymorphicPointer = thiz;
-        scriptClass->internalState_.internalStore_ =
-            hermes_interop::makeLocal<Value>(facebook::jsi::Array(runtime, 0));
+        engine->adjustAssociatedMemory(
+            static_cast<int64_t>(classDefine->instanceDefine.instanceSize));
 
         if (registry.prototype.val_.valuePtr != nullptr) {
-          auto Object = runtime.global().getPropertyAsObject(runtime, "Object");
-          auto createFunc = Object.getPropertyAsFunction(runtime, "create");
+          // this runs for every instance, use cached PropNameID instead of creating from ascii
+          auto Object = runtime.global()
+                            .getProperty(runtime, getCachedPropNameID(runtime, Prop::Object))
+                            .asObject(runtime);
+          auto createFunc = Object.getProperty(runtime, getCachedPropNameID(runtime, Prop::Create))
+                                .asObject(runtime)
+                                .asFunction(runtime);
 
           auto obj = createFunc.call(runtime, *registry.prototype.val_.valuePtr);
           obj.asObject(runtime).setNativeState(
               runtime, std::make_shared<SharedScriptClassHolder>(scriptClass));
+          scriptClass->internalState_.weakRef_.emplace(runtime, obj.getObject(runtime));
 
           return obj;
         }
 
         thisValue.asObject(runtime).setNativeState(
             runtime, std::make_shared<SharedScriptClassHolder>(scriptClass));
+        scriptClass->internalState_.weakRef_.emplace(runtime, thisValue.getObject(runtime));
 
         return {};
       });
 
   return hermes_interop::makeLocal<Object>(
-      rt.global().getPropertyAsFunction(rt, "makeNativeClass").call(rt, constructor));
+      rt.global()
+          .getProperty(rt, getCachedPropNameID(rt, Prop::MakeNativeClass))
+          .asObject(rt)
+          .asFunction(rt)
+          .call(rt, constructor));
 }
 
 Local<Object> HermesEngine::defineInstancePrototype(const internal::ClassDefineState* classDefine) {
@@ -182,8 +193,11 @@ Local<Object> HermesEngine::defineInstancePrototype(const internal::ClassDefineS
     auto parentRegistry = classRegistry_.find(classDefine->getParent());
     if (parentRegistry != classRegistry_.end()) {
       auto& rt = getRt();
-      auto Object = rt.global().getPropertyAsObject(rt, "Object");
-      auto setPrototypeOf = Object.getPropertyAsFunction(rt, "setPrototypeOf");
+      auto Object =
+          rt.global().getProperty(rt, getCachedPropNameID(rt, Prop::Object)).asObject(rt);
+      auto setPrototypeOf = Object.getProperty(rt, getCachedPropNameID(rt, Prop::SetPrototypeOf))
+                                .asObject(rt)
+                                .asFunction(rt);
 
       setPrototypeOf.call(rt,
           *proto.val_.valuePtr,
@@ -225,9 +239,10 @@ void HermesEngine::defineInstanceFunction(const internal::ClassDefineState* clas
       }
 
       Tracer trace(engine, f.traceName);
+      StackFrameScope stack;
 
       auto scriptArgs = hermes_interop::makeArguments(engine, thisVal, args, count);
-      const auto res = (f.callback)(getThisPointer(rt, thisVal), scriptArgs);
+      const auto res = f.call(getThisPointer(rt, thisVal), scriptArgs);
 
       return hermes_interop::moveHermes(res);
     };
@@ -242,8 +257,11 @@ void HermesEngine::defineInstanceFunction(const internal::ClassDefineState* clas
 
 void HermesEngine::defineInstanceProperties(const internal::ClassDefineState* classDefine,
                                             const Local<Object>& prototype) {
-  auto Object = getRt().global().getPropertyAsObject(getRt(), "Object");
-  auto defineProperties = Object.getPropertyAsFunction(getRt(), "defineProperties");
+  auto& rt = getRt();
+  auto Object = rt.global().getProperty(rt, getCachedPropNameID(rt, Prop::Object)).asObject(rt);
+  auto defineProperties = Object.getProperty(rt, getCachedPropNameID(rt, Prop::DefineProperties))
+                              .asObject(rt)
+                              .asFunction(rt);
   auto get = String::newString("get");
   auto set = String::newString("set");
 
@@ -276,8 +294,11 @@ void HermesEngine::registerStaticDefine(const internal::StaticDefine& staticDefi
   }
 
   if (!staticDefine.properties.empty()) {
-    auto Object = getRt().global().getPropertyAsObject(getRt(), "Object");
-    auto defineProperties = Object.getPropertyAsFunction(getRt(), "defineProperties");
+    auto& rt = getRt();
+    auto Object = rt.global().getProperty(rt, getCachedPropNameID(rt, Prop::Object)).asObject(rt);
+    auto defineProperties = Object.getProperty(rt, getCachedPropNameID(rt, Prop::DefineProperties))
+                                .asObject(rt)
+                                .asFunction(rt);
     auto get = String::newString("get");
     auto set = String::newString("set");
 
@@ -313,6 +334,7 @@ Local<Value> HermesEngine::newStaticSetter(const internal::StaticDefine::Propert
     }
 
     Tracer trace(engine, prop.name);
+    StackFrameScope stack;
 
     auto scriptArgs = hermes_interop::makeArguments(engine, thisVal, args, count);
     (prop.setter)(scriptArgs[0]);
@@ -337,6 +359,7 @@ Local<Value> HermesEngine::newStaticGetter(const internal::StaticDefine::Propert
     }
 
     Tracer trace(engine, prop.name);
+    StackFrameScope stack;
     const auto res = (prop.getter)();
 
     return hermes_interop::moveHermes(res);
@@ -358,8 +381,9 @@ Local<Function> HermesEngine::newStaticFunction(
     }
 
     Tracer trace(engine, func.traceName);
+    StackFrameScope stack;
     auto scriptArgs = hermes_interop::makeArguments(engine, thisVal, args, count);
-    const auto res = (func.callback)(scriptArgs);
+    const auto res = func.call(scriptArgs);
 
     return hermes_interop::moveHermes(res);
   };
@@ -382,6 +406,7 @@ Local<Value> HermesEngine::newInstanceSetter(const internal::InstanceDefine::Pro
     }
 
     Tracer trace(engine, prop.name);
+    StackFrameScope stack;
 
     auto scriptArgs = hermes_interop::makeArguments(engine, thisVal, args, count);
     (prop.setter)(getThisPointer(rt, thisVal), scriptArgs[0]);
@@ -406,6 +431,7 @@ Local<Value> HermesEngine::newInstanceGetter(const internal::InstanceDefine::Pro
     }
 
     Tracer trace(engine, prop.name);
+    StackFrameScope stack;
     const auto res = (prop.getter)(getThisPointer(rt, thisVal));
 
     return hermes_interop::moveHermes(res);
@@ -421,7 +447,7 @@ Local<Object> HermesEngine::performNewNativeClass(internal::TypeIndex typeIndex,
                                                   size_t size, const Local<script::Value>* args) {
   auto it = classRegistry_.find(classDefine);
   if (it != classRegistry_.end()) {
-    Local<Value> constructor(it->second.constructor.val_);
+    auto constructor = it->second.constructor.getValue();
     return Object::newObjectImpl(constructor, size, args);
   }
 
@@ -441,10 +467,10 @@ bool HermesEngine::performIsInstanceOf(const Local<script::Value>& value,
       return true;
     }
 
-    if (obj.hasNativeState(rt)) {
-      void* privateData = obj.getNativeState(rt).get();
+    if (obj.hasNativeState<SharedScriptClassHolder>(rt)) {
+      auto holder = obj.getNativeState<SharedScriptClassHolder>(rt);
       auto* objectClassDefine = static_cast<const internal::ClassDefineState*>(
-          static_cast<SharedScriptClassHolder*>(privateData)->sc->internalState_.classDefine);
+          holder->sc->internalState_.classDefine);
 
       if (objectClassDefine == classDefine)
         return true;
@@ -459,14 +485,25 @@ bool HermesEngine::performIsInstanceOf(const Local<script::Value>& value,
 
 void* HermesEngine::performGetNativeInstance(const Local<script::Value>& value,
                                              const internal::ClassDefineState* classDefine) {
-  if (value.isObject() && performIsInstanceOf(value, classDefine)) {
-    auto& rt = getRt();
-    auto obj = value.val_.valuePtr->getObject(rt);
-    void* privateData = obj.getNativeState(rt).get();
-    return static_cast<SharedScriptClassHolder*>(privateData)
-        ->sc->internalState_.polymorphicPointer;
+  if (!value.isObject()) return nullptr;
+
+  // the native state records the class define, no need to call instanceof in script
+  auto& rt = getRt();
+  auto obj = value.val_.valuePtr->getObject(rt);
+  // only instances carry SharedScriptClassHolder, skip NonOwningSharedScriptClassHolder
+  // and native states set by others
+  if (!obj.hasNativeState<SharedScriptClassHolder>(rt)) return nullptr;
+
+  auto sc = obj.getNativeState<SharedScriptClassHolder>(rt)->sc;
+  if (sc == nullptr) return nullptr;
+
+  auto* objectClassDefine =
+      static_cast<const internal::ClassDefineState*>(sc->internalState_.classDefine);
+  if (!objectClassDefine ||
+      (objectClassDefine != classDefine && !objectClassDefine->isChildOf(classDefine))) {
+    return nullptr;
   }
-  return nullptr;
+  return sc->internalState_.polymorphicPointer;
 }
 
 }  // namespace script::hermes_backend
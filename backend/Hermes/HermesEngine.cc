@@ -16,6 +16,11 @@
  */
 
 #include "HermesEngine.h"
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
 #include "../../src/Utils.h"
 
 #include "HermesHelper.hpp"
@@ -24,8 +29,31 @@
 namespace script::hermes_backend {
 
 HermesEngine::HermesEngine(std::shared_ptr<utils::MessageQueue> queue)
-    : messageQueue_(queue ? std::move(queue) : std::make_shared<utils::MessageQueue>()) {
+    : HermesEngine(std::move(queue), EngineOptions{}) {}
+
+HermesEngine::HermesEngine(std::shared_ptr<utils::MessageQueue> queue,
+                           const EngineOptions& options)
+    : messageQueue_(queue ? std::move(queue) : std::make_shared<utils::MessageQueue>()),
+      options_(options) {
+  auto gcConfig = hermes::vm::GCConfig::Builder();
+  if (options_.maxHeapSize != 0) {
+    gcConfig.withMaxHeapSize(static_cast<hermes::vm::gcheapsize_t>(options_.maxHeapSize));
+  }
+  if (options_.initialHeapSize != 0) {
+    gcConfig.withInitHeapSize(static_cast<hermes::vm::gcheapsize_t>(options_.initialHeapSize));
+  }
+  if (options_.nearHeapLimitCallback && options_.maxHeapSize != 0) {
+    gcConfig.withTripwireConfig(
+        hermes::vm::GCTripwireConfig::Builder()
+            .withLimit(static_cast<hermes::vm::gcheapsize_t>(options_.nearHeapLimit()))
+            .withCallback([this](hermes::vm::GCTripwireContext&) {
+              options_.nearHeapLimitCallback(this);
+            })
+            .build());
+  }
+
   const auto runtimeConfig = hermes::vm::RuntimeConfig::Builder()
+                                 .withGCConfig(gcConfig.build())
                                  .withIntl(false)
                                  .withEnableHermesInternal(true)
                                  .withMicrotaskQueue(true)
@@ -53,6 +81,8 @@ void HermesEngine::destroy() noexcept {
 
   globalWeakBookkeeping_.clear();
   classRegistry_.clear();
+  // Local can't outlive the runtime
+  handleArena_.clear();
 
   invalidatePropNameCache = nullptr;
   delete runtime_;
@@ -62,15 +92,18 @@ Local<Object> HermesEngine::getGlobal() {
   return hermes_interop::makeLocal<Object>(runtime_->global());
 }
 
+// use the jsi::String key directly, going through std::string would copy it out and back
 Local<Value> HermesEngine::get(const Local<String>& key) {
+  auto& runtime = *runtime_;
   return hermes_interop::makeLocal<Value>(
-      runtime_->global().getProperty(*runtime_, key.toString().c_str()));
+      runtime.global().getProperty(runtime, key.val_.valuePtr->asString(runtime)));
 }
 
 void HermesEngine::set(const Local<String>& key, const Local<Value>& value) {
   try {
-    auto copy = value;
-    runtime_->global().setProperty(*runtime_, key.toString().c_str(), *copy.val_.valuePtr);
+    auto& runtime = *runtime_;
+    runtime.global().setProperty(runtime, key.val_.valuePtr->asString(runtime),
+                                 *value.val_.valuePtr);
   } catch (const facebook::jsi::JSIException& e) {
     throw Exception(std::string(e.what()));
   }
@@ -151,18 +184,211 @@ Local<Value> HermesEngine::evalInPlaceInternal(const std::shared_ptr<facebook::j
   return Local<Value>(std::move(ret));
 }
 
+namespace {
+
+struct PreparedScriptCache {
+  struct Entry {
+    size_t hash;
+    std::string sourceUrl;
+    std::shared_ptr<const facebook::jsi::Buffer> source;
+    HermesEngine::PreparedScript prepared;
+    // memory held by prepared beyond source, see preparedBytes()
+    size_t preparedBytes;
+
+    size_t bytes() const { return sourceUrl.size() + source->size() + preparedBytes; }
+  };
+
+  // jsi::PreparedJavaScript doesn't expose its size, so it's derived from the input:
+  // hermes bytecode runs from the source buffer in place and adds nothing, while text is
+  // compiled into a bytecode module of about the source size, kept next to the source buffer.
+  static size_t preparedBytes(const facebook::jsi::Buffer& source) {
+    if (facebook::hermes::HermesRuntime::isHermesBytecode(source.data(), source.size())) {
+      return 0;
+    }
+    return source.size();
+  }
+
+  std::mutex lock;
+  size_t maxBytes = HermesEngine::kDefaultPreparedCacheMaxBytes;
+  // bytes of retained source and prepared scripts
+  size_t bytes = 0;
+  // front is the most recently used
+  std::list<Entry> lru;
+  std::unordered_multimap<size_t, std::list<Entry>::iterator> index;
+
+  static PreparedScriptCache& instance() {
+    static PreparedScriptCache cache;
+    return cache;
+  }
+
+  // must be called with lock held
+  HermesEngine::PreparedScript find(size_t hash, std::string_view script,
+                                    const std::string& sourceUrl) {
+    auto range = index.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      auto& entry = *it->second;
+      auto& source = *entry.source;
+      if (entry.sourceUrl == sourceUrl && source.size() == script.size() &&
+          std::memcmp(source.data(), script.data(), script.size()) == 0) {
+        lru.splice(lru.begin(), lru, it->second);
+        return entry.prepared;
+      }
+    }
+    return {};
+  }
+
+  // must be called with lock held
+  void put(Entry entry) {
+    auto entryBytes = entry.bytes();
+    // too large to keep, the caller still gets its handle
+    if (entryBytes > maxBytes) return;
+    evictUntil(maxBytes - entryBytes);
+    bytes += entryBytes;
+    auto hash = entry.hash;
+    lru.push_front(std::move(entry));
+    index.emplace(hash, lru.begin());
+  }
+
+  // must be called with lock held
+  void evictUntil(size_t limit) {
+    while (bytes > limit && !lru.empty()) {
+      auto last = std::prev(lru.end());
+      auto range = index.equal_range(last->hash);
+      for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == last) {
+          index.erase(it);
+          break;
+        }
+      }
+      bytes -= last->bytes();
+      lru.erase(last);
+    }
+  }
+
+  // must be called with lock held
+  void clear() {
+    index.clear();
+    lru.clear();
+    bytes = 0;
+  }
+};
+
+}  // namespace
+
+HermesEngine::PreparedScript HermesEngine::prepare(const Local<String>& script,
+                                                   const std::string& sourceUrl) {
+  return prepare(script.toString(), sourceUrl);
+}
+
+HermesEngine::PreparedScript HermesEngine::prepare(const std::string& script,
+                                                   const std::string& sourceUrl) {
+  Tracer trace(this, "HermesEngine::prepare");
+  auto& cache = PreparedScriptCache::instance();
+  auto hash = std::hash<std::string_view>()(script) ^ (std::hash<std::string>()(sourceUrl) << 1);
+
+  {
+    std::lock_guard<std::mutex> lock(cache.lock);
+    if (auto prepared = cache.find(hash, script, sourceUrl)) return prepared;
+  }
+
+  // compile outside of the lock, a large bundle may take a while
+  auto source = std::make_shared<facebook::jsi::StringBuffer>(script);
+  PreparedScript prepared;
+  try {
+    prepared = runtime_->prepareJavaScript(source, sourceUrl);
+  } catch (facebook::jsi::JSError& e) {
+    auto val = facebook::jsi::Value(*runtime_, e.value());
+    throw Exception(hermes_interop::makeLocal<Value>(std::move(val)));
+  } catch (facebook::jsi::JSIException& e) {
+    std::string msg = e.what();
+    throw Exception(msg);
+  }
+
+  std::lock_guard<std::mutex> lock(cache.lock);
+  // another engine may have prepared the same script meanwhile, keep the first one
+  if (auto existing = cache.find(hash, script, sourceUrl)) return existing;
+  auto preparedBytes = PreparedScriptCache::preparedBytes(*source);
+  cache.put({hash, sourceUrl, std::move(source), prepared, preparedBytes});
+  return prepared;
+}
+
+Local<Value> HermesEngine::evaluatePrepared(const PreparedScript& prepared) {
+  Tracer trace(this, "HermesEngine::evaluatePrepared");
+  if (!prepared) throw Exception("evaluatePrepared on empty PreparedScript");
+  facebook::jsi::Value ret;
+
+  try {
+    ret = runtime_->evaluatePreparedJavaScript(prepared);
+  } catch (facebook::jsi::JSError& e) {
+    auto val = facebook::jsi::Value(*runtime_, e.value());
+    throw Exception(hermes_interop::makeLocal<Value>(std::move(val)));
+  } catch (facebook::jsi::JSIException& e) {
+    std::string msg = e.what();
+    throw Exception(msg);
+  }
+
+  runtime_->drainMicrotasks(-1);
+  return Local<Value>(std::move(ret));
+}
+
+void HermesEngine::clearPreparedCache() {
+  auto& cache = PreparedScriptCache::instance();
+  std::lock_guard<std::mutex> lock(cache.lock);
+  cache.clear();
+}
+
+void HermesEngine::setPreparedCacheMaxBytes(size_t maxBytes) {
+  auto& cache = PreparedScriptCache::instance();
+  std::lock_guard<std::mutex> lock(cache.lock);
+  cache.maxBytes = maxBytes;
+  cache.evictUntil(maxBytes);
+}
+
 std::shared_ptr<utils::MessageQueue> HermesEngine::messageQueue() { return messageQueue_; }
 
 size_t HermesEngine::getHeapSize() {
   const auto info = runtime_->instrumentation().getHeapInfo(false);
-  return info.at("hermes_heapSize");
+  return info.at("hermes_heapSize") + associatedMemory_.total();
+}
+
+HeapStatistics HermesEngine::getHeapStatistics() {
+  const auto info = runtime_->instrumentation().getHeapInfo(false);
+  auto get = [&info](const char* key) -> size_t {
+    auto it = info.find(key);
+    return it == info.end() ? 0 : static_cast<size_t>(it->second);
+  };
+
+  HeapStatistics statistics;
+  statistics.usedHeapSize = get("hermes_allocatedBytes");
+  statistics.totalHeapSize = get("hermes_heapSize");
+  statistics.heapSizeLimit = options_.maxHeapSize;
+  // reported memory is already part of hermes_externalBytes
+  statistics.externalMemory =
+      get("hermes_externalBytes") + associatedMemory_.total() - associatedMemory_.reported();
+  statistics.gcCount = get("hermes_numCollections");
+  return statistics;
 }
 
 void HermesEngine::gc() {
-  if (!isDestroying()) runtime_->instrumentation().collectGarbage("c++ engine function called");
+  if (isDestroying()) return;
+  associatedMemory_.onGc();
+  runtime_->instrumentation().collectGarbage("c++ engine function called");
 }
 
-void HermesEngine::adjustAssociatedMemory(int64_t count) {}
+void HermesEngine::adjustAssociatedMemory(int64_t count) {
+  if (isDestroying()) return;
+  if (associatedMemory_.adjust(count)) {
+    gc();
+  }
+}
+
+void HermesEngine::adjustReportedMemory(int64_t count) { associatedMemory_.adjustReported(count); }
+
+void HermesEngine::setAssociatedMemoryGcThreshold(size_t threshold) {
+  associatedMemory_.setGcThreshold(threshold);
+}
+
+size_t HermesEngine::getAssociatedMemory() const { return associatedMemory_.total(); }
 
 ScriptLanguage HermesEngine::getLanguageType() { return ScriptLanguage::kJavaScript; }
 
@@ -200,6 +426,10 @@ void HermesEngine::scheduleTick() {
 }
 
 void HermesEngine::deleteScriptClass(script::ScriptClass* sc) {
+  if (auto classDefine =
+          static_cast<const internal::ClassDefineState*>(sc->internalState_.classDefine)) {
+    adjustAssociatedMemory(-static_cast<int64_t>(classDefine->instanceDefine.instanceSize));
+  }
   if (!isDestroying()) {
     utils::Message dtor([](auto& msg) {},
                         [](auto& msg) { delete static_cast<ScriptClass*>(msg.ptr0); });
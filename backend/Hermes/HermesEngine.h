@@ -20,10 +20,12 @@
 #include "../../src/Engine.h"
 #include "../../src/Exception.h"
 #include "../../src/Native.h"
+#include "../../src/utils/AssociatedMemory.h"
 #include "../../src/utils/GlobalWeakBookkeeping.hpp"
 #include "../../src/utils/MessageQueue.h"
 
 #include "HermesHelper.h"
+#include "HermesScope.h"
 #include "HermesTypedArrayApi.h"
 
 namespace script::hermes_backend {
@@ -47,11 +49,23 @@ class HermesEngine : public ScriptEngine {
 
   internal::GlobalWeakBookkeeping globalWeakBookkeeping_{};
 
+  HandleArena handleArena_{};
+
   std::unordered_map<const void*, ClassRegistryData> classRegistry_;
 
+  utils::AssociatedMemoryCounter associatedMemory_{};
+
+  EngineOptions options_{};
+
  public:
   HermesEngine(std::shared_ptr<::script::utils::MessageQueue> queue);
 
+  /**
+   * @param options maxHeapSize and initialHeapSize -> GCConfig,
+   * nearHeapLimitCallback -> GC tripwire (checked after each gc), gcThreshold is ignored.
+   */
+  HermesEngine(std::shared_ptr<::script::utils::MessageQueue> queue, const EngineOptions& options);
+
   HermesEngine();
 
   SCRIPTX_DISALLOW_COPY_AND_MOVE(HermesEngine);
@@ -77,13 +91,64 @@ class HermesEngine : public ScriptEngine {
 
   using ScriptEngine::eval;
 
+  using PreparedScript = std::shared_ptr<const facebook::jsi::PreparedJavaScript>;
+
+  // default of setPreparedCacheMaxBytes
+  static constexpr size_t kDefaultPreparedCacheMaxBytes = 32 * 1024 * 1024;
+
+  /**
+   * Compile script (source or hermes bytecode) into a handle that can be evaluated repeatedly.
+   * Prepared scripts are runtime independent and cached process-wide by content and sourceUrl,
+   * so every HermesEngine preparing the same bundle shares one PreparedJavaScript.
+   * The cache is bounded by the bytes of source and prepared script it retains,
+   * least recently prepared scripts are evicted first.
+   */
+  PreparedScript prepare(const std::string& script, const std::string& sourceUrl = {});
+  PreparedScript prepare(const Local<String>& script, const std::string& sourceUrl = {});
+
+  Local<Value> evaluatePrepared(const PreparedScript& prepared);
+
+  /**
+   * drop every cached PreparedScript, handles already returned stay valid.
+   */
+  static void clearPreparedCache();
+
+  /**
+   * bound the bytes retained by the process-wide PreparedScript cache, each script is charged
+   * for its source plus the bytecode compiled from it (about the source size for text,
+   * nothing for hermes bytecode which runs in place).
+   * scripts larger than maxBytes are prepared but not cached.
+   */
+  static void setPreparedCacheMaxBytes(size_t maxBytes);
+
   std::shared_ptr<utils::MessageQueue> messageQueue() override;
 
   size_t getHeapSize() override;
+
+  HeapStatistics getHeapStatistics() override;
   void gc() override;
 
   void adjustAssociatedMemory(int64_t count) override;
 
+  /**
+   * record native memory already reported to the hermes GC through
+   * jsi::Object::setExternalMemoryPressure (ByteBuffers do so automatically),
+   * it's counted by getAssociatedMemory but never triggers a GC.
+   */
+  void adjustReportedMemory(int64_t count);
+
+  /**
+   * Native memory reported via adjustAssociatedMemory (ScriptClass instances report
+   * automatically).
+   * jsi has no engine wide external memory API, so a GC is run every time threshold bytes
+   * have been associated since the last GC.
+   *
+   * @param threshold bytes, 0 to disable, default utils::AssociatedMemoryCounter::kDefaultGcThreshold
+   */
+  void setAssociatedMemoryGcThreshold(size_t threshold);
+
+  size_t getAssociatedMemory() const;
+
   ScriptLanguage getLanguageType() override;
 
   std::string getEngineVersion() override;
@@ -141,6 +206,10 @@ class HermesEngine : public ScriptEngine {
 
   friend class HermesEngineScope;
 
+  friend class StackFrameScopeImpl;
+
+  friend class ::script::internal::ValueHolder;
+
   friend struct ::script::hermes_interop;
   template <typename T>
   friend struct MakeLocalInternal;
@@ -51,6 +51,10 @@ struct hermes_interop {
     return engine->runtime_;
   }
 
+  static const hermes_backend::HandleArena& getHandleArena(hermes_backend::HermesEngine* engine) {
+    return engine->handleArena_;
+  }
+
   static hermes_backend::HermesRuntime* currentEngineRuntime() {
     return ::script::hermes_backend::currentRuntime();
   }
@@ -85,12 +89,25 @@ struct hermes_interop {
     return script::Arguments(hermes_backend::ArgumentsData{engine, thisVal, count, args});
   }
 
-  static facebook::jsi::Value* toHermes(const Local<Value>& val) { return val.val_.valuePtr.get(); }
+  static facebook::jsi::Value* toHermes(const Local<Value>& val) { return val.val_.valuePtr; }
+
+  /**
+   * copy the value out of the HandleArena
+   */
   static std::shared_ptr<facebook::jsi::Value> toShared(const Local<Value>& val) {
-    return val.val_.valuePtr;
+    if (val.val_.valuePtr == nullptr) return nullptr;
+    return std::make_shared<facebook::jsi::Value>(*currentEngineRuntime(), *val.val_.valuePtr);
   }
-  static facebook::jsi::Value&& moveHermes(const Local<Value>& val) {
-    return std::move(*val.val_.valuePtr.get());
+
+  /**
+   * steal the value from its arena slot, used to return Local from host functions.
+   */
+  static facebook::jsi::Value moveHermes(const Local<Value>& val) {
+    auto value = val.val_.valuePtr;
+    // primitives are cheap to copy, and Local<Value>() refers to a shared undefined
+    if (value == nullptr || value->isUndefined()) return facebook::jsi::Value::undefined();
+    if (value->isNull()) return facebook::jsi::Value::null();
+    return std::move(*value);
   }
 
   static std::vector<facebook::jsi::Value> toJsiVector(const Local<Value>* args, size_t size) {
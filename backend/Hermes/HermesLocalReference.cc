@@ -31,9 +31,23 @@ void valueConstructorCheck(const facebook::jsi::Value& value) {
 
 namespace internal {
 
-ValueHolder::ValueHolder(const facebook::jsi::Value& value)
-    : valuePtr(std::make_shared<facebook::jsi::Value>(*script::hermes_backend::currentRuntime(),
-                                                      value)) {}
+ValueHolder::ValueHolder(const facebook::jsi::Value& value) {
+  auto engine = script::hermes_backend::currentEngine();
+  valuePtr = engine->handleArena_.emplace(*hermes_interop::getEngineRuntime(engine), value);
+}
+
+ValueHolder::ValueHolder(facebook::jsi::Value&& value)
+    : valuePtr(script::hermes_backend::currentEngine()->handleArena_.emplace(std::move(value))) {}
+
+facebook::jsi::Value* ValueHolder::undefinedValue() {
+  static facebook::jsi::Value undefined;
+  return &undefined;
+}
+
+facebook::jsi::Value* ValueHolder::nullValue() {
+  static facebook::jsi::Value null = facebook::jsi::Value::null();
+  return &null;
+}
 
 }  // namespace internal
 
@@ -110,7 +124,7 @@ REF_IMPL_TO_VALUE(Unsupported)
 
 // ==== value ====
 
-Local<Value>::Local() noexcept : val_(facebook::jsi::Value()) {}
+Local<Value>::Local() noexcept : val_(internal::ValueHolder::undefinedValue()) {}
 
 Local<Value>::Local(InternalLocalRef hermesLocal) : val_(hermesLocal) {}
 
@@ -121,7 +135,7 @@ bool Local<Value>::isNull() const {
 }
 
 void Local<Value>::reset() {
-  val_.valuePtr = std::make_shared<facebook::jsi::Value>(facebook::jsi::Value::null());
+  val_ = internal::ValueHolder(internal::ValueHolder::nullValue());
 }
 
 ValueKind Local<Value>::getKind() const {
@@ -334,8 +348,8 @@ void Local<Array>::set(size_t index, const script::Local<script::Value>& value)
   if ((int)index > (int)size() - 1)
     val_.valuePtr->asObject(runtime).asArray(runtime).setLength(runtime, index + 1);
 
-  val_.valuePtr->asObject(runtime).asArray(runtime).setValueAtIndex(
-      runtime, index, std::move(*value.val_.valuePtr));
+  val_.valuePtr->asObject(runtime).asArray(runtime).setValueAtIndex(runtime, index,
+                                                                   *value.val_.valuePtr);
 }
 
 void Local<Array>::add(const script::Local<script::Value>& value) const {
@@ -65,10 +65,7 @@ void ScriptClass::performConstructFromCpp(internal::TypeIndex typeIndex,
   auto thiz = hermes_interop::makeLocal<Value>(std::move(jsiObj));
   auto obj = engine->performNewNativeClass(typeIndex, classDefine, 1, &thiz);
 
-  if (obj == thiz)
-    internalState_.weakRef_ = hermes_interop::toShared(thiz);
-  else
-    internalState_.weakRef_ = hermes_interop::toShared(obj);
+  internalState_.weakRef_.emplace(runtime, hermes_interop::toHermes(obj)->getObject(runtime));
 }
 
 hermes_backend::HermesScriptClassState::HermesScriptClassState(HermesEngine* scriptEngine,
@@ -81,26 +78,29 @@ ScriptClass::ScriptClass(const script::Local<script::Object>& scriptObject)
 Local<Object> ScriptClass::getScriptObject() const {
   auto* runtime = hermes_interop::getEngineRuntime(internalState_.scriptEngine_);
 
-  if (auto val = internalState_.weakRef_)
-    return hermes_interop::makeLocal<Object>(val->asObject(*runtime));
+  if (internalState_.weakRef_) {
+    auto val = internalState_.weakRef_->lock(*runtime);
+    if (val.isObject()) return hermes_interop::makeLocal<Object>(std::move(val));
+  }
 
   return Object::newObject();
 }
 
 Local<Array> ScriptClass::getInternalStore() const {
-  auto& store = internalState_.internalStore_;
-  if (!store.isArray()) {
-    auto* runtime = hermes_interop::getEngineRuntime(internalState_.scriptEngine_);
-    const_cast<ScriptClass*>(this)->internalState_.internalStore_ =
-        hermes_interop::makeLocal<Value>(facebook::jsi::Array(*runtime, 0));
+  auto& store = const_cast<ScriptClass*>(this)->internalState_.internalStore_;
+  if (store.isEmpty()) {
+    store = Array::newArray();
   }
-  return internalState_.internalStore_.asArray();
+  return store.get();
 }
 
 ScriptEngine* ScriptClass::getScriptEngine() const { return internalState_.scriptEngine_; }
 
 bool ScriptClass::isScriptObjectNull() const {
-  if (auto val = internalState_.weakRef_) return val->isNull();
+  if (internalState_.weakRef_) {
+    auto* runtime = hermes_interop::getEngineRuntime(internalState_.scriptEngine_);
+    return !internalState_.weakRef_->lock(*runtime).isObject();
+  }
   return true;
 }
 
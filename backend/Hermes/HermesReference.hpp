@@ -50,8 +50,10 @@ Global<T>::Global() noexcept : val_() {}
 
 template <typename T>
 Global<T>::Global(const script::Local<T>& localReference) : val_() {
-  val_.valuePtr = localReference.val_.valuePtr;
   val_.engine_ = hermes_backend::currentEngine();
+  // promote out of the HandleArena
+  val_.valuePtr = std::make_shared<facebook::jsi::Value>(
+      *hermes_interop::getEngineRuntime(val_.engine_), *localReference.val_.valuePtr);
   hermes_backend::BookKeep::keep(this);
 }
 
@@ -111,13 +113,13 @@ Global<T>& Global<T>::operator=(const script::Local<T>& assign) {
 template <typename T>
 Local<T> Global<T>::get() const {
   if (isEmpty()) throw Exception("get on empty Global");
-  return Local<T>(val_);
+  return hermes_backend::HermesEngine::make<Local<T>>(internal::ValueHolder(*val_.valuePtr));
 }
 
 template <typename T>
 Local<Value> Global<T>::getValue() const {
   if (isEmpty()) return {};
-  return Local<Value>(val_);
+  return Local<Value>(internal::ValueHolder(*val_.valuePtr));
 }
 
 template <typename T>
@@ -146,8 +148,14 @@ Weak<T>::~Weak() {
 
 template <typename T>
 Weak<T>::Weak(const script::Local<T>& localReference) : val_() {
-  if (auto shared = hermes_interop::toShared(localReference)) val_.valuePtr = shared;
   val_.engine_ = hermes_backend::currentEngine();
+  auto& runtime = *hermes_interop::getEngineRuntime(val_.engine_);
+  auto& value = *localReference.val_.valuePtr;
+  if (value.isObject()) {
+    val_.weakRef = std::make_shared<facebook::jsi::WeakObject>(runtime, value.getObject(runtime));
+  } else {
+    val_.valuePtr = std::make_shared<facebook::jsi::Value>(runtime, value);
+  }
   hermes_backend::BookKeep::keep(this);
 }
 
@@ -188,6 +196,7 @@ Weak<T>& Weak<T>::operator=(script::Weak<T>&& move) noexcept {
 template <typename T>
 void Weak<T>::swap(Weak& rhs) noexcept {
   if (&rhs != this) {
+    std::swap(val_.weakRef, rhs.val_.weakRef);
     std::swap(val_.valuePtr, rhs.val_.valuePtr);
     std::swap(val_.engine_, rhs.val_.engine_);
     hermes_backend::BookKeep::afterSwap(this, &rhs);
@@ -210,7 +219,12 @@ Local<T> Weak<T>::get() const {
 template <typename T>
 Local<Value> Weak<T>::getValue() const {
   if (isEmpty()) return {};
-  if (auto shared = val_.valuePtr.lock(); shared != nullptr) return Local<Value>(*shared);
+  if (val_.weakRef) {
+    // undefined if collected
+    auto& runtime = *hermes_interop::getEngineRuntime(val_.engine_);
+    return Local<Value>(internal::ValueHolder(val_.weakRef->lock(runtime)));
+  }
+  if (val_.valuePtr) return Local<Value>(internal::ValueHolder(*val_.valuePtr));
   return {};
 }
 
@@ -222,6 +236,7 @@ bool Weak<T>::isEmpty() const {
 template <typename T>
 void Weak<T>::reset() noexcept {
   if (isEmpty()) return;
+  val_.weakRef.reset();
   val_.valuePtr.reset();
   hermes_backend::BookKeep::remove(this);
   val_.engine_ = nullptr;
@@ -24,10 +24,22 @@
 namespace script::hermes_backend {
 
 HermesEngineScope::HermesEngineScope(HermesEngine& engine, HermesEngine* previous)
-    : scope_(*engine.runtime_), engine_(engine) {}
+    : scope_(*engine.runtime_), engine_(engine), mark_(engine.handleArena_.mark()) {}
 
 HermesEngineScope::~HermesEngineScope() {
   engine_.getRt().drainMicrotasks(-1);
+  engine_.handleArena_.release(mark_);
+}
+
+StackFrameScopeImpl::StackFrameScopeImpl(HermesEngine& engine)
+    : engine_(&engine),
+      // reserved in the enclosing frame, so returnValue() survives this frame
+      returnSlot_(engine.handleArena_.emplace()),
+      base_(engine.handleArena_.mark()) {}
+
+StackFrameScopeImpl::~StackFrameScopeImpl() {
+  // the reserved slot is given back too, unless returnValue() used it
+  engine_->handleArena_.release(hasReturnValue_ ? base_ : base_ - 1);
 }
 
 }  // namespace script::hermes_backend
@@ -17,7 +17,12 @@
 
 #pragma once
 
+#include <cstddef>
+#include <memory>
 #include <mutex>
+#include <new>
+#include <vector>
+#include "../../src/foundation.h"
 #include "../../src/types.h"
 
 #include "HermesHelper.h"
@@ -26,10 +31,91 @@ namespace script::hermes_backend {
 
 class HermesEngine;
 
+/**
+ * Storage of every Local<T> on Hermes.
+ *
+ * A Local is a plain pointer to a jsi::Value slot in this arena, so creating, copying or casting
+ * a Local never touches the heap. Slots live in fixed-size blocks (addresses are stable) and are
+ * released in LIFO order when the HermesEngineScope or StackFrameScope that created them exits.
+ * Global and Weak copy the value out of the arena.
+ *
+ * All slots must be released while the runtime is still alive.
+ */
+class HandleArena {
+ public:
+  using Mark = size_t;
+
+  static constexpr size_t kBlockShift = 8;
+  static constexpr size_t kBlockSize = static_cast<size_t>(1) << kBlockShift;
+  // blocks kept around after the outermost scope exits
+  static constexpr size_t kRetainedBlocks = 4;
+
+ private:
+  struct Block {
+    alignas(facebook::jsi::Value) std::byte storage[sizeof(facebook::jsi::Value) * kBlockSize];
+  };
+
+  std::vector<std::unique_ptr<Block>> blocks_;
+  size_t size_ = 0;
+  size_t blockAllocations_ = 0;
+
+  facebook::jsi::Value* slotAt(size_t index) const {
+    auto* block = blocks_[index >> kBlockShift].get();
+    return std::launder(reinterpret_cast<facebook::jsi::Value*>(block->storage)) +
+           (index & (kBlockSize - 1));
+  }
+
+ public:
+  HandleArena() = default;
+
+  SCRIPTX_DISALLOW_COPY_AND_MOVE(HandleArena);
+
+  template <typename... Args>
+  facebook::jsi::Value* emplace(Args&&... args) {
+    if (size_ == blocks_.size() * kBlockSize) {
+      blocks_.push_back(std::make_unique<Block>());
+      ++blockAllocations_;
+    }
+    auto* slot = slotAt(size_);
+    new (slot) facebook::jsi::Value(std::forward<Args>(args)...);
+    ++size_;
+    return slot;
+  }
+
+  Mark mark() const { return size_; }
+
+  /**
+   * destroy all values allocated after mark.
+   */
+  void release(Mark mark) noexcept {
+    while (size_ > mark) {
+      slotAt(--size_)->~Value();
+    }
+    if (size_ == 0 && blocks_.size() > kRetainedBlocks) {
+      blocks_.resize(kRetainedBlocks);
+    }
+  }
+
+  void clear() noexcept { release(0); }
+
+  /**
+   * number of live values
+   */
+  size_t size() const { return size_; }
+
+  size_t capacity() const { return blocks_.size() * kBlockSize; }
+
+  /**
+   * how many blocks have ever been allocated, used to verify steady-state calls are heap-free.
+   */
+  size_t blockAllocations() const { return blockAllocations_; }
+};
+
 class HermesEngineScope {
  private:
   facebook::jsi::Scope scope_;
   HermesEngine& engine_;
+  HandleArena::Mark mark_;
 
  public:
   explicit HermesEngineScope(HermesEngine&, HermesEngine*);
@@ -0,0 +1,34 @@
+/*
+ * Tencent is pleased to support the open source community by making ScriptX available.
+ * Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "HermesEngine.h"
+#include "HermesHelper.hpp"
+#include "trait/TraitScope.h"
+
+namespace script::hermes_backend {
+
+template <typename T>
+Local<T> StackFrameScopeImpl::returnValue(const Local<T> &localRef) {
+  auto &runtime = *hermes_interop::getEngineRuntime(engine_);
+  hasReturnValue_ = true;
+  *returnSlot_ = facebook::jsi::Value(runtime, *hermes_interop::toHermes(localRef.asValue()));
+  return HermesEngine::make<Local<T>>(internal::ValueHolder(returnSlot_));
+}
+
+}  // namespace script::hermes_backend
@@ -1,5 +1,6 @@
 #include "HermesTypedArrayApi.h"
 
+#include <mutex>
 #include <unordered_map>
 #include <stdexcept>
 
@@ -9,50 +10,31 @@ namespace hermes_backend {
 template <TypedArrayKind T>
 using ContentType = typename typedArrayTypeMap<T>::type;
 
-enum class Prop {
-  Buffer,             // "buffer"
-  Constructor,        // "constructor"
-  Name,               // "name"
-  Proto,              // "__proto__"
-  Length,             // "length"
-  ByteLength,         // "byteLength"
-  ByteOffset,         // "offset"
-  IsView,             // "isView"
-  ArrayBuffer,        // "ArrayBuffer"
-  Int8Array,          // "Int8Array"
-  Int16Array,         // "Int16Array"
-  Int32Array,         // "Int32Array"
-  Uint8Array,         // "Uint8Array"
-  Uint8ClampedArray,  // "Uint8ClampedArray"
-  Uint16Array,        // "Uint16Array"
-  Uint32Array,        // "Uint32Array"
-  Float32Array,       // "Float32Array"
-  Float64Array,       // "Float64Array"
-  DataView,           // "DataView"
-};
-
+// shared by engines living on different threads, guarded by lock.
+// entries are node based, so a returned PropNameID stays in place until its runtime is destroyed.
 class PropNameIDCache {
  public:
   const jsi::PropNameID &get(jsi::Runtime &runtime, Prop prop) {
     auto key = reinterpret_cast<uintptr_t>(&runtime);
-    if (this->props.find(key) == this->props.end()) {
-      this->props[key] = std::unordered_map<Prop, std::unique_ptr<jsi::PropNameID>>();
-    }
-    if (!this->props[key][prop]) {
-      this->props[key][prop] = std::make_unique<jsi::PropNameID>(createProp(runtime, prop));
+    std::lock_guard<std::mutex> guard(lock);
+    auto &runtimeProps = this->props[key];
+    auto &cached = runtimeProps[prop];
+    if (!cached) {
+      cached = std::make_unique<jsi::PropNameID>(createProp(runtime, prop));
     }
-    return *(this->props[key][prop]);
+    return *cached;
   }
 
   const jsi::PropNameID &getConstructorNameProp(jsi::Runtime &runtime, TypedArrayKind kind);
 
   void invalidate(uintptr_t key) {
-    if (props.find(key) != props.end()) {
-      props[key].clear();
-    }
+    std::lock_guard<std::mutex> guard(lock);
+    // drop the whole entry, so the map does not grow with every runtime ever created
+    props.erase(key);
   }
 
  private:
+  std::mutex lock;
   std::unordered_map<uintptr_t, std::unordered_map<Prop, std::unique_ptr<jsi::PropNameID>>> props;
 
   jsi::PropNameID createProp(jsi::Runtime &runtime, Prop prop);
@@ -60,6 +42,10 @@ class PropNameIDCache {
 
 PropNameIDCache propNameIDCache;
 
+const jsi::PropNameID &getCachedPropNameID(jsi::Runtime &runtime, Prop prop) {
+  return propNameIDCache.get(runtime, prop);
+}
+
 InvalidateCacheOnDestroy::InvalidateCacheOnDestroy(jsi::Runtime &runtime) {
   key = reinterpret_cast<uintptr_t>(&runtime);
 }
@@ -274,6 +260,16 @@ jsi::PropNameID PropNameIDCache::createProp(jsi::Runtime &runtime, Prop prop) {
       return create("Float64Array");
     case Prop::DataView:
       return create("DataView");
+    case Prop::Object:
+      return create("Object");
+    case Prop::Create:
+      return create("create");
+    case Prop::SetPrototypeOf:
+      return create("setPrototypeOf");
+    case Prop::DefineProperties:
+      return create("defineProperties");
+    case Prop::MakeNativeClass:
+      return create("makeNativeClass");
   }
 }
 
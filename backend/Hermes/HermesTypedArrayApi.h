@@ -61,6 +61,36 @@ struct typedArrayTypeMap<TypedArrayKind::Float64Array> {
   typedef double type;
 };
 
+enum class Prop {
+  Buffer,             // "buffer"
+  Constructor,        // "constructor"
+  Name,               // "name"
+  Proto,              // "__proto__"
+  Length,             // "length"
+  ByteLength,         // "byteLength"
+  ByteOffset,         // "offset"
+  IsView,             // "isView"
+  ArrayBuffer,        // "ArrayBuffer"
+  Int8Array,          // "Int8Array"
+  Int16Array,         // "Int16Array"
+  Int32Array,         // "Int32Array"
+  Uint8Array,         // "Uint8Array"
+  Uint8ClampedArray,  // "Uint8ClampedArray"
+  Uint16Array,        // "Uint16Array"
+  Uint32Array,        // "Uint32Array"
+  Float32Array,       // "Float32Array"
+  Float64Array,       // "Float64Array"
+  DataView,           // "DataView"
+  Object,             // "Object"
+  Create,             // "create"
+  SetPrototypeOf,     // "setPrototypeOf"
+  DefineProperties,   // "defineProperties"
+  MakeNativeClass,    // "makeNativeClass"
+};
+
+// PropNameID of prop, created once per jsi::Runtime and reused afterwards
+const jsi::PropNameID &getCachedPropNameID(jsi::Runtime &runtime, Prop prop);
+
 // Instance of this class will invalidate PropNameIDCache when destructor is called.
 // Attach this object to global in specific jsi::Runtime to make sure lifecycle of
 // the cache object is connected to the lifecycle of the js runtime
@@ -105,6 +105,7 @@ Local<Function> Function::newFunction(script::FunctionCallback callback) {
       throw Exception(std::string("Invalid Runtime"));
     }
 
+    StackFrameScope stack;
     auto scriptArgs = hermes_interop::makeArguments(engine, thisVal, args, count);
     const auto res = sharedCallback->callback_(scriptArgs);
 
@@ -126,28 +127,57 @@ Local<Array> Array::newArrayImpl(size_t size, const Local<Value>* args) {
   return arr;
 }
 
+namespace {
+
+// backing storage lives outside of the hermes heap, the hermes GC is told about it through
+// setExternalMemoryPressure on the ArrayBuffer, the engine only records it as associated memory
+struct AssociatedBackingData : public internal::BackingData {
+  template <typename... Args>
+  explicit AssociatedBackingData(hermes_backend::HermesEngine* engine, Args&&... args)
+      : BackingData(std::forward<Args>(args)...), engine_(engine) {
+    engine_->adjustReportedMemory(static_cast<int64_t>(size_));
+  }
+
+  ~AssociatedBackingData() override {
+    engine_->adjustReportedMemory(-static_cast<int64_t>(size_));
+  }
+
+  hermes_backend::HermesEngine* engine_;
+};
+
+facebook::jsi::ArrayBuffer newArrayBuffer(const std::shared_ptr<AssociatedBackingData>& data) {
+  auto& runtime = *hermes_backend::currentRuntime();
+  facebook::jsi::ArrayBuffer buffer(runtime, data);
+  // released by the GC together with the ArrayBuffer
+  buffer.setExternalMemoryPressure(runtime, data->size());
+  return buffer;
+}
+
+}  // namespace
+
 Local<ByteBuffer> ByteBuffer::newByteBuffer(size_t size) {
-  auto backingData = std::make_shared<internal::BackingData>(size);
-  auto res = hermes_interop::makeLocal<ByteBuffer>(
-      facebook::jsi::ArrayBuffer(*hermes_backend::currentRuntime(), backingData));
+  auto backingData =
+      std::make_shared<AssociatedBackingData>(hermes_backend::currentEngine(), size);
+  auto res = hermes_interop::makeLocal<ByteBuffer>(newArrayBuffer(backingData));
 
   res.val_.backingData_ = backingData;
   return res;
 }
 
 Local<script::ByteBuffer> ByteBuffer::newByteBuffer(void* nativeBuffer, size_t size) {
-  auto backingData = std::make_shared<internal::BackingData>(nativeBuffer, size);
-  auto res = hermes_interop::makeLocal<ByteBuffer>(
-      facebook::jsi::ArrayBuffer(*hermes_backend::currentRuntime(), backingData));
+  auto backingData =
+      std::make_shared<AssociatedBackingData>(hermes_backend::currentEngine(), nativeBuffer, size);
+  auto res = hermes_interop::makeLocal<ByteBuffer>(newArrayBuffer(backingData));
 
   res.val_.backingData_ = backingData;
   return res;
 }
 
 Local<ByteBuffer> ByteBuffer::newByteBuffer(std::shared_ptr<void> nativeBuffer, size_t size) {
-  auto backingData = std::make_shared<internal::BackingData>(nativeBuffer, size);
-  auto res = hermes_interop::makeLocal<ByteBuffer>(
-      facebook::jsi::ArrayBuffer(*hermes_backend::currentRuntime(), backingData));
+  // no copy, the ArrayBuffer is backed by nativeBuffer itself
+  auto backingData = std::make_shared<AssociatedBackingData>(hermes_backend::currentEngine(),
+                                                             std::move(nativeBuffer), size);
+  auto res = hermes_interop::makeLocal<ByteBuffer>(newArrayBuffer(backingData));
 
   res.val_.backingData_ = backingData;
   return res;
@@ -21,6 +21,7 @@
 #include "../HermesHelper.hpp"
 #include "../HermesNative.hpp"
 #include "../HermesReference.hpp"
+#include "../HermesScope.hpp"
 
 // global marco
 #define SCRIPTX_BACKEND_HERMES
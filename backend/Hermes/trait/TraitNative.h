@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <optional>
+
 namespace script {
 
 namespace hermes_backend {
@@ -35,8 +37,9 @@ struct HermesScriptClassState {
   HermesEngine* scriptEngine_ = nullptr;
   const void* classDefine = nullptr;
   void* polymorphicPointer = nullptr;
-  Local<Value> internalStore_;
-  std::shared_ptr<facebook::jsi::Value> weakRef_;
+  Global<Array> internalStore_;
+  // weak, so the script object (and this ScriptClass with it) can be collected
+  std::optional<facebook::jsi::WeakObject> weakRef_;
 };
 
 struct SharedScriptClassHolder : public facebook::jsi::NativeState {
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
 #include <string>
 #include "../../src/types.h"
 #include "../../src/utils/GlobalWeakBookkeeping.hpp"
@@ -27,16 +28,20 @@
 namespace script::internal {
 
 struct BackingData : public facebook::jsi::MutableBuffer {
-  BackingData(size_t s) {
-    data_ = std::shared_ptr<uint8_t>(new uint8_t[s], std::default_delete<uint8_t[]>());
-    size_ = s;
+  // zero-filled storage, as required by ArrayBuffer semantics
+  explicit BackingData(size_t s)
+      : data_(new uint8_t[s](), std::default_delete<uint8_t[]>()), size_(s) {}
+
+  // copy mode, storage is left uninitialized since it's overwritten right away
+  BackingData(void* data, size_t s)
+      : data_(new uint8_t[s], std::default_delete<uint8_t[]>()), size_(s) {
+    std::memcpy(data_.get(), data, s);
   }
-  BackingData(void* data, size_t s) : BackingData(s) { std::memcpy(data_.get(), data, s); }
 
-  BackingData(std::shared_ptr<void> data, size_t s) {
-    data_ = data;
-    size_ = s;
-  }
+  // zero-copy mode, wraps caller's memory directly.
+  // the deleter of data acts as the release callback,
+  // and is called once both script and native side drop the buffer.
+  BackingData(std::shared_ptr<void> data, size_t s) : data_(std::move(data)), size_(s) {}
 
   size_t size() const override { return size_; }
   uint8_t* data() override { return reinterpret_cast<uint8_t*>(data_.get()); }
@@ -45,37 +50,50 @@ struct BackingData : public facebook::jsi::MutableBuffer {
   size_t size_;
 };
 
+/**
+ * Local reference, points to a slot of hermes_backend::HandleArena owned by the current scope.
+ * Copy is a pointer copy.
+ */
 class ValueHolder {
  public:
   ValueHolder() {}
+  // copy value into current engine's HandleArena
   ValueHolder(const facebook::jsi::Value& value);
-  ValueHolder(facebook::jsi::Value&& value)
-      : valuePtr(std::make_shared<facebook::jsi::Value>(std::move(value))) {}
+  ValueHolder(facebook::jsi::Value&& value);
+  // refer to an existing arena slot
+  explicit ValueHolder(facebook::jsi::Value* slot) : valuePtr(slot) {}
 
-  ValueHolder(const ValueHolder& other) : valuePtr(other.valuePtr) {}
-  ValueHolder(ValueHolder&& other) : valuePtr(std::move(other.valuePtr)) {}
+  ValueHolder(const ValueHolder& other) = default;
+  ValueHolder& operator=(const ValueHolder& assign) = default;
 
-  ValueHolder& operator=(const ValueHolder& assign) {
-    valuePtr = assign.valuePtr;
-    return *this;
+  ValueHolder(ValueHolder&& other) noexcept : valuePtr(other.valuePtr) {
+    other.valuePtr = nullptr;
   }
 
   ValueHolder& operator=(ValueHolder&& move) noexcept {
-    valuePtr = std::move(move.valuePtr);
+    valuePtr = move.valuePtr;
+    move.valuePtr = nullptr;
     return *this;
   }
 
-  std::shared_ptr<facebook::jsi::Value> valuePtr;
+  /**
+   * shared undefined value for Local<Value>() which can be created without EngineScope.
+   * never write through it.
+   */
+  static facebook::jsi::Value* undefinedValue();
+
+  // shared null value for Local<Value>::reset(), never write through it.
+  static facebook::jsi::Value* nullValue();
+
+  facebook::jsi::Value* valuePtr = nullptr;
 };
 
-class GlobalValueHolder : public ValueHolder {
+class GlobalValueHolder {
  public:
   GlobalValueHolder() {}
-  GlobalValueHolder(const facebook::jsi::Value& value);
-  GlobalValueHolder(facebook::jsi::Value&& value) : ValueHolder(value) {}
 
-  GlobalValueHolder(const GlobalValueHolder& other) : ValueHolder(other) {}
-  GlobalValueHolder(GlobalValueHolder&& other) : ValueHolder(std::move(other)) {}
+  GlobalValueHolder(const GlobalValueHolder& other) : valuePtr(other.valuePtr) {}
+  GlobalValueHolder(GlobalValueHolder&& other) : valuePtr(std::move(other.valuePtr)) {}
 
   GlobalValueHolder& operator=(const GlobalValueHolder& assign) {
     valuePtr = assign.valuePtr;
@@ -90,6 +108,7 @@ class GlobalValueHolder : public ValueHolder {
     return *this;
   }
 
+  std::shared_ptr<facebook::jsi::Value> valuePtr;
   hermes_backend::HermesEngine* engine_ = nullptr;
   internal::GlobalWeakBookkeeping::HandleType handle_{};
 };
@@ -98,23 +117,27 @@ class WeakValueHolder {
  public:
   WeakValueHolder() {}
   WeakValueHolder(const WeakValueHolder& other)
-      : valuePtr(other.valuePtr), engine_(other.engine_) {}
-  WeakValueHolder(const std::shared_ptr<facebook::jsi::Value>& val) : valuePtr(val) {}
+      : weakRef(other.weakRef), valuePtr(other.valuePtr), engine_(other.engine_) {}
 
   WeakValueHolder& operator=(const WeakValueHolder& assign) {
+    weakRef = assign.weakRef;
     valuePtr = assign.valuePtr;
     engine_ = assign.engine_;
     return *this;
   }
 
   WeakValueHolder& operator=(WeakValueHolder&& move) noexcept {
+    weakRef = std::move(move.weakRef);
     valuePtr = std::move(move.valuePtr);
     engine_ = move.engine_;
     move.engine_ = nullptr;
     return *this;
   }
 
-  std::weak_ptr<facebook::jsi::Value> valuePtr;
+  // objects are observed through a runtime weak reference
+  std::shared_ptr<facebook::jsi::WeakObject> weakRef;
+  // primitives can't be collected, keep a copy
+  std::shared_ptr<facebook::jsi::Value> valuePtr;
   hermes_backend::HermesEngine* engine_ = nullptr;
   internal::GlobalWeakBookkeeping::HandleType handle_{};
 };
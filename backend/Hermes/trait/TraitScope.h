@@ -37,19 +37,19 @@ class ExitEngineScopeImpl {
 };
 
 class StackFrameScopeImpl {
+ private:
+  HermesEngine *engine_;
+  facebook::jsi::Value *returnSlot_;
+  HandleArena::Mark base_;
+  bool hasReturnValue_ = false;
+
  public:
-  explicit StackFrameScopeImpl(HermesEngine &) {
-    // enter stack;
-  }
+  explicit StackFrameScopeImpl(HermesEngine &);
 
-  ~StackFrameScopeImpl() {
-    // exit stack;
-  }
+  ~StackFrameScopeImpl();
 
   template <typename T>
-  Local<T> returnValue(const Local<T> &localRef) {
-    return localRef;
-  }
+  Local<T> returnValue(const Local<T> &localRef);
 };
 }  // namespace hermes_backend
 
@@ -193,7 +193,6 @@ void JscEngine::defineInstanceFunction(const internal::ClassDefineState* classDe
       auto fp = data->functionDefine;
       auto engine = data->engine;
       auto def = data->classDefine;
-      auto& callback = fp->callback;
 
       Tracer trace(engine, fp->traceName);
 
@@ -209,7 +208,7 @@ void JscEngine::defineInstanceFunction(const internal::ClassDefineState* classDe
         if (objectClassDefine != def && !objectClassDefine->isChildOf(def)) {
           throw Exception(u8"call function on wrong receiver");
         }
-        auto returnVal = callback(t->internalState_.polymorphicPointer, args);
+        auto returnVal = fp->call(t->internalState_.polymorphicPointer, args);
         return toJsc(engine->context_, returnVal);
       } catch (Exception& e) {
         *exception = jsc_backend::JscEngine::toJsc(engine->context_, e.exception());
@@ -351,7 +351,7 @@ Local<Function> JscEngine::newStaticFunction(const internal::StaticDefine::Funct
     auto args = newArguments(engine, thisObject, arguments, argumentCount);
 
     try {
-      auto returnVal = (funcPtr->first->callback)(args);
+      auto returnVal = funcPtr->first->call(args);
       return toJsc(engine->context_, returnVal);
     } catch (Exception& e) {
       *exception = jsc_backend::JscEngine::toJsc(engine->context_, e.exception());
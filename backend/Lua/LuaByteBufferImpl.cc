@@ -16,13 +16,102 @@
  */
 
 #include "LuaByteBufferImpl.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
 #include "../../src/Engine.hpp"
 #include "../../src/Native.hpp"
+#include "LuaHelper.hpp"
 
 namespace script::lua_backend {
 
 namespace {
 
+/**
+ * ByteBuffer:bytes(), a uint8 view on a full userdata.
+ * view[i] goes through __index/__newindex C functions directly,
+ * instead of a bound instance function of the ByteBuffer class.
+ */
+struct ByteView {
+  std::shared_ptr<void> buffer;
+  size_t size;
+};
+
+constexpr auto kByteViewMetaTable = "ScriptX.ByteView";
+
+int byteViewIndex(lua_State *lua) {
+  auto view = static_cast<ByteView *>(lua_touserdata(lua, 1));
+  auto index = lua_isnumber(lua, 2) ? lua_tointeger(lua, 2) : 0;
+  if (index < 1 || static_cast<size_t>(index) > view->size) {
+    lua_pushnil(lua);
+  } else {
+    lua_pushinteger(lua, static_cast<uint8_t *>(view->buffer.get())[index - 1]);
+  }
+  return 1;
+}
+
+int byteViewNewIndex(lua_State *lua) {
+  auto view = static_cast<ByteView *>(lua_touserdata(lua, 1));
+  auto index = lua_isnumber(lua, 2) ? lua_tointeger(lua, 2) : 0;
+  if (index < 1 || static_cast<size_t>(index) > view->size) {
+    // no C++ object alive in this frame, safe to longjmp
+    luaThrow(lua, "ByteView index out of range");
+  }
+  static_cast<uint8_t *>(view->buffer.get())[index - 1] =
+      static_cast<uint8_t>(lua_tointeger(lua, 3));
+  return 0;
+}
+
+int byteViewLength(lua_State *lua) {
+  auto view = static_cast<ByteView *>(lua_touserdata(lua, 1));
+  lua_pushinteger(lua, static_cast<lua_Integer>(view->size));
+  return 1;
+}
+
+int byteViewGc(lua_State *lua) {
+  static_cast<ByteView *>(lua_touserdata(lua, 1))->~ByteView();
+  return 0;
+}
+
+Local<Value> newByteView(lua_State *lua, std::shared_ptr<void> buffer, size_t size) {
+  luaEnsureStack(lua, 3);
+  auto memory = lua_newuserdata(lua, sizeof(ByteView));
+  new (memory) ByteView{std::move(buffer), size};
+
+  if (luaL_newmetatable(lua, kByteViewMetaTable)) {
+    lua_pushcfunction(lua, byteViewIndex);
+    lua_setfield(lua, -2, kLuaMetaMethodIndex);
+    lua_pushcfunction(lua, byteViewNewIndex);
+    lua_setfield(lua, -2, kLuaMetaMethodNewIndex);
+    lua_pushcfunction(lua, byteViewLength);
+    lua_setfield(lua, -2, "__len");
+    lua_pushcfunction(lua, byteViewGc);
+    lua_setfield(lua, -2, kLuaMetaMethodNewGc);
+  }
+  lua_setmetatable(lua, -2);
+
+  return lua_interop::makeLocal<Value>(lua_gettop(lua));
+}
+
+template <typename T>
+void pushElement(lua_State *lua, T value) {
+  if constexpr (std::is_floating_point_v<T>) {
+    lua_pushnumber(lua, static_cast<lua_Number>(value));
+  } else {
+    lua_pushinteger(lua, static_cast<lua_Integer>(value));
+  }
+}
+
+template <typename T>
+T toElement(lua_State *lua, int index) {
+  if constexpr (std::is_floating_point_v<T>) {
+    return static_cast<T>(lua_tonumber(lua, index));
+  } else {
+    // same as Local<Number>::toInt64
+    return static_cast<T>(static_cast<int64_t>(lua_tonumber(lua, index)));
+  }
+}
+
 class LuaByteBuffer;
 
 const ClassDefine<LuaByteBuffer> &luaByteBufferDefine();
@@ -72,7 +161,135 @@ class LuaByteBuffer : public ScriptClass {
     return readPtr<T>(pos);
   }
 
+  // bulk operations, one native call for a whole range
+
+  /**
+   * readXxxArray(pos, count) -> table of count elements
+   */
+  template <typename T>
+  Local<Value> readArray(int32_t pos, int32_t count) {
+    auto data = rangePtr<T>(pos, count);
+    auto lua = currentLua();
+    luaEnsureStack(lua, 2);
+    lua_createtable(lua, count, 0);
+    for (int32_t i = 0; i < count; ++i) {
+      pushElement(lua, reinterpret_cast<const T *>(data)[i]);
+      lua_rawseti(lua, -2, i + 1);
+    }
+    return lua_interop::makeLocal<Value>(lua_gettop(lua));
+  }
+
+  /**
+   * writeXxxArray(pos, table) -> self, write #table elements
+   */
+  template <typename T>
+  Local<Value> writeArray(int32_t pos, const Local<Value> &table) {
+    auto lua = currentLua();
+    auto index = lua_interop::toLua(table);
+    if (index == 0 || !lua_istable(lua, index)) {
+      throw Exception("ByteBuffer write array expects a table");
+    }
+    auto count = static_cast<int32_t>(lua_rawlen(lua, index));
+    auto data = reinterpret_cast<T *>(rangePtr<T>(pos, count));
+    luaEnsureStack(lua, 1);
+    for (int32_t i = 0; i < count; ++i) {
+      lua_rawgeti(lua, index, i + 1);
+      data[i] = toElement<T>(lua, -1);
+      lua_pop(lua, 1);
+    }
+    return getScriptObject();
+  }
+
+  /**
+   * fill(byte [, pos [, length]]) -> self
+   */
+  Local<Value> fill(const Arguments &args) {
+    auto value = static_cast<uint8_t>(args[0].asNumber().toInt32());
+    auto pos = optionalInt(args, 1, 1);
+    auto length = optionalInt(args, 2, static_cast<int64_t>(size_) - (pos - 1));
+    std::memset(rangePtr<uint8_t>(pos, length), value, static_cast<size_t>(length));
+    return getScriptObject();
+  }
+
+  /**
+   * copy(target [, targetPos [, pos [, length]]]) -> self
+   * copy bytes from this buffer to target, target can be this buffer.
+   */
+  Local<Value> copy(const Arguments &args) {
+    auto target = args.engine()->getNativeInstance<LuaByteBuffer>(args[0]);
+    if (target == nullptr) {
+      throw Exception("ByteBuffer copy target is not a ByteBuffer");
+    }
+    auto targetPos = optionalInt(args, 1, 1);
+    auto pos = optionalInt(args, 2, 1);
+    auto length = optionalInt(
+        args, 3,
+        std::min(static_cast<int64_t>(size_) - (pos - 1),
+                 static_cast<int64_t>(target->size_) - (targetPos - 1)));
+    std::memmove(target->rangePtr<uint8_t>(targetPos, length), rangePtr<uint8_t>(pos, length),
+                 static_cast<size_t>(length));
+    return getScriptObject();
+  }
+
+  /**
+   * readString([pos [, length]]) -> lua string holding the raw bytes
+   */
+  Local<Value> readString(const Arguments &args) {
+    auto pos = optionalInt(args, 0, 1);
+    auto length = optionalInt(args, 1, static_cast<int64_t>(size_) - (pos - 1));
+    auto data = rangePtr<uint8_t>(pos, length);
+    auto lua = currentLua();
+    luaEnsureStack(lua, 1);
+    lua_pushlstring(lua, reinterpret_cast<const char *>(data), static_cast<size_t>(length));
+    return lua_interop::makeLocal<Value>(lua_gettop(lua));
+  }
+
+  /**
+   * writeString(str [, pos]) -> self, write the raw bytes of str
+   */
+  Local<Value> writeString(const Arguments &args) {
+    auto lua = currentLua();
+    auto index = lua_interop::toLua(args[0]);
+    if (index == 0 || lua_type(lua, index) != LUA_TSTRING) {
+      throw Exception("ByteBuffer writeString expects a string");
+    }
+    size_t length;
+    auto str = lua_tolstring(lua, index, &length);
+    auto pos = optionalInt(args, 1, 1);
+    std::memcpy(rangePtr<uint8_t>(pos, static_cast<int64_t>(length)), str, length);
+    return getScriptObject();
+  }
+
+  int64_t size() const { return static_cast<int64_t>(size_); }
+
+  /**
+   * bytes() -> uint8 view supports view[i], view[i] = v and #view
+   */
+  Local<Value> bytes() { return newByteView(currentLua(), nativeBuffer_, size_); }
+
  private:
+  static int64_t optionalInt(const Arguments &args, size_t index, int64_t defaultValue) {
+    if (args.size() > index && args[index].isNumber()) {
+      return args[index].asNumber().toInt64();
+    }
+    return defaultValue;
+  }
+
+  /**
+   * check [pos, pos + count * sizeof(T)) is in range and aligned, pos is 1-based
+   */
+  template <typename T>
+  uint8_t *rangePtr(int64_t pos, int64_t count) {
+    if (pos < 1 || count < 0 ||
+        static_cast<uint64_t>(pos - 1) + static_cast<uint64_t>(count) * sizeof(T) > size_) {
+      throwIndexOutOfRange(static_cast<uint32_t>(pos));
+    }
+    if ((pos - 1) % sizeof(T) != 0) {
+      throwNotAlignedMemoryAccess(static_cast<uint32_t>(pos - 1), sizeof(T));
+    }
+    return static_cast<uint8_t *>(nativeBuffer_.get()) + (pos - 1);
+  }
+
   template <typename T>
   T &writePtr(int32_t pos) {
     // lua use 1-based index
@@ -115,9 +332,11 @@ class LuaByteBuffer : public ScriptClass {
 // TODO(taylor): byte order native
 
 const ClassDefine<LuaByteBuffer> &luaByteBufferDefine() {
-#define type(name, type)                                       \
-  instanceFunction("write" #name, &LuaByteBuffer::write<type>) \
-      .instanceFunction("read" #name, &LuaByteBuffer::read<type>)
+#define type(name, type)                                                           \
+  instanceFunction("write" #name, &LuaByteBuffer::write<type>)                     \
+      .instanceFunction("read" #name, &LuaByteBuffer::read<type>)                  \
+      .instanceFunction("write" #name "Array", &LuaByteBuffer::writeArray<type>)   \
+      .instanceFunction("read" #name "Array", &LuaByteBuffer::readArray<type>)
 
   static auto define = defineClass<LuaByteBuffer>("ByteBuffer")
                            .constructor()
@@ -131,6 +350,12 @@ const ClassDefine<LuaByteBuffer> &luaByteBufferDefine() {
                            .type(Int64, int64_t)
                            .type(Float, float)
                            .type(Double, double)
+                           .instanceFunction("fill", &LuaByteBuffer::fill)
+                           .instanceFunction("copy", &LuaByteBuffer::copy)
+                           .instanceFunction("readString", &LuaByteBuffer::readString)
+                           .instanceFunction("writeString", &LuaByteBuffer::writeString)
+                           .instanceFunction("size", &LuaByteBuffer::size)
+                           .instanceFunction("bytes", &LuaByteBuffer::bytes)
                            .build();
 #undef type
 
@@ -163,6 +388,16 @@ std::shared_ptr<void> LuaByteBufferImpl::getByteBuffer(LuaEngine *engine,
   throw Exception("Object is not a ByteBuffer");
 }
 
+void *LuaByteBufferImpl::getByteBufferPointer(LuaEngine *engine,
+                                              const Local<Value> &byteBuffer) {
+  auto ptr = engine->getNativeInstance<LuaByteBuffer>(byteBuffer);
+  if (ptr) {
+    return ptr->getNativeBuffer().get();
+  }
+
+  throw Exception("Object is not a ByteBuffer");
+}
+
 size_t LuaByteBufferImpl::getByteBufferSize(LuaEngine *engine, const Local<Value> &byteBuffer) {
   auto ptr = engine->getNativeInstance<LuaByteBuffer>(byteBuffer);
   if (ptr) {
@@ -37,6 +37,8 @@ class LuaByteBufferImpl : public LuaByteBufferDelegate {
 
   size_t getByteBufferSize(LuaEngine *engine, const Local<Value> &byteBuffer) override;
 
+  void *getByteBufferPointer(LuaEngine *engine, const Local<Value> &byteBuffer) override;
+
   bool isByteBuffer(LuaEngine *engine, const Local<Value> &byteBuffer) override;
 };
 
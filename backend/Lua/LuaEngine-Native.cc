@@ -240,7 +240,7 @@ void LuaEngine::defineInstanceFunctions(const internal::ClassDefineState* classD
           [](lua_State* lua, void* data, void* thiz, const Arguments& args) -> Local<Value> {
             auto fd = static_cast<FD*>(data);
             Tracer trace(args.engine(), fd->traceName);
-            return fd->callback(thiz, args);
+            return fd->call(thiz, args);
           });
       lua_rawset(lua_, instanceFunctionTable);
     }
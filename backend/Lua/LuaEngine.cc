@@ -69,10 +69,12 @@ const void* const LuaEngine::kLuaWeakRegistryToken_ =
 
 LuaEngine::LuaEngine(std::shared_ptr<::script::utils::MessageQueue> queue,
                      const std::function<lua_State*()>& luaStateFactory,
-                     std::unique_ptr<LuaByteBufferDelegate> byteBufferDelegate)
+                     std::unique_ptr<LuaByteBufferDelegate> byteBufferDelegate,
+                     const EngineOptions& options)
     : messageQueue_(queue ? std::move(queue) : std::make_shared<utils::MessageQueue>()),
       byteBufferDelegate_(byteBufferDelegate ? std::move(byteBufferDelegate)
-                                             : std::make_unique<LuaByteBufferImpl>()) {
+                                             : std::make_unique<LuaByteBufferImpl>()),
+      options_(options) {
   if (luaStateFactory) {
     lua_ = luaStateFactory();
     assert(lua_);
@@ -80,12 +82,20 @@ LuaEngine::LuaEngine(std::shared_ptr<::script::utils::MessageQueue> queue,
     lua_ = newCommonLua();
   }
 
+  if (options_.maxHeapSize != 0) {
+    installLimitedAllocator();
+  }
+
   {
     EngineScope engineScope(this);
     initGlobalRegistry();
     byteBufferDelegate_->init(this);
     registerNativeClass(builtInFunctions());
   }
+
+  if (options_.gcThreshold != 0) {
+    applyGcThreshold();
+  }
 }
 
 LuaEngine::~LuaEngine() = default;
@@ -107,20 +117,63 @@ void LuaEngine::destroy() {
   delete this;
 }
 
-bool lua_backend::LuaEngine::isDestroying() const { return isDestroying_; }
+void LuaEngine::applyGcThreshold() {
+  // lua has no absolute threshold, the collector pauses until the heap reaches pause% of the
+  // memory in use after the previous cycle. Size the pause so that the first cycle starts after
+  // gcThreshold bytes of growth over the initialized heap, later cycles scale with live memory.
+  constexpr size_t kMinPause = 100;
+  // lua 5.4 stores pause / 4 in a byte
+  constexpr size_t kMaxPause = 1000;
+  auto heapSize = (std::max)(getHeapSize(), size_t(1));
+  auto pause = std::clamp(kMinPause + options_.gcThreshold * 100 / heapSize, kMinPause, kMaxPause);
+#if LUA_VERSION_NUM >= 504
+  // 0 keeps the current step multiplier and step size
+  lua_gc(lua_, LUA_GCINC, static_cast<int>(pause), 0, 0);
+#else
+  lua_gc(lua_, LUA_GCSETPAUSE, static_cast<int>(pause));
+#endif
+}
 
-void LuaEngine::initGlobalRegistry() {
-  lua_getglobal(lua_, kLuaGlobalEnvName);
-  auto global = lua_gettop(lua_);
+void LuaEngine::installLimitedAllocator() {
+  originalAlloc_ = lua_getallocf(lua_, &originalAllocUserData_);
+  allocatedBytes_ = static_cast<size_t>(lua_gc(lua_, LUA_GCCOUNT, 0)) * 1024 +
+                    static_cast<size_t>(lua_gc(lua_, LUA_GCCOUNTB, 0));
 
-  luaStackScope(lua_, [this, global]() {
-    // global
-    lua_newtable(lua_);
-    lua_rawsetp(lua_, global, kLuaGlobalRegistryToken_);
-  });
+  lua_setallocf(
+      lua_,
+      [](void* ud, void* ptr, size_t osize, size_t nsize) -> void* {
+        auto engine = static_cast<LuaEngine*>(ud);
+        // when ptr is nullptr, osize is the type tag of the new object
+        auto oldSize = ptr ? osize : 0;
+        if (nsize > oldSize && engine->allocatedBytes_ + (nsize - oldSize) >
+                                   engine->options_.maxHeapSize) {
+          // lua runs an emergency gc and raises a memory error
+          // never fail a shrink (nsize <= oldSize), lua assumes it can't fail
+          return nullptr;
+        }
 
-  luaStackScope(lua_, [this, global] {
-    // weak
+        auto ret = engine->originalAlloc_(engine->originalAllocUserData_, ptr, osize, nsize);
+        if (ret == nullptr && nsize != 0) return nullptr;
+        engine->allocatedBytes_ = engine->allocatedBytes_ - oldSize + nsize;
+
+        if (engine->options_.nearHeapLimitCallback && !engine->isDestroying_) {
+          auto near = engine->allocatedBytes_ >= engine->options_.nearHeapLimit();
+          if (near && !engine->nearHeapLimitNotified_) {
+            engine->options_.nearHeapLimitCallback(engine);
+          }
+          engine->nearHeapLimitNotified_ = near;
+        }
+        return ret;
+      },
+      this);
+}
+
+bool lua_backend::LuaEngine::isDestroying() const { return isDestroying_; }
+
+void LuaEngine::initGlobalRegistry() {
+  // Global values live directly in the lua registry via luaL_ref,
+  // Weak values live in a weak-value table which is itself anchored in the registry.
+  luaStackScope(lua_, [this] {
     lua_newtable(lua_);
 
     luaStackScope(lua_, [this] {
@@ -135,52 +188,55 @@ void LuaEngine::initGlobalRegistry() {
       lua_setmetatable(lua_, -2);
     });
 
-    lua_rawsetp(lua_, global, kLuaWeakRegistryToken_);
+    weakTableRef_ = luaL_ref(lua_, LUA_REGISTRYINDEX);
   });
 }
 
+// luaL_ref returns LUA_REFNIL for nil, which must not collide with the empty id 0
+static constexpr size_t kGlobalNilRef = static_cast<size_t>(LUA_REFNIL);
+
 size_t LuaEngine::putGlobalOrWeakTable(const Local<Value>& localReference,
                                        const void* registryToken) {
-  size_t id = 0;
-  if (localReference.val_ != 0) {
-    StackFrameScope scope;
-    lua_getglobal(lua_, kLuaGlobalEnvName);
-    auto global = lua_gettop(lua_);
-    lua_rawgetp(lua_, global, registryToken);
-    auto globalTable = lua_gettop(lua_);
+  if (localReference.val_ == 0) return 0;
 
-    auto counter = globalIdCounter();
-
-    make<Local<Array>>(globalTable).set(counter, localReference);
-
-    // pop globalTable
-    lua_pop(this->lua_, 1);
+  size_t id = 0;
+  luaStackScope(lua_, [this, &localReference, registryToken, &id]() {
+    luaEnsureStack(lua_, 2);
 
-    id = counter;
     if (registryToken == kLuaGlobalRegistryToken_) {
+      lua_pushvalue(lua_, localReference.val_);
+      id = static_cast<size_t>(luaL_ref(lua_, LUA_REGISTRYINDEX));
       globalRefCount_++;
     } else {
+      if (freeWeakSlots_.empty()) {
+        id = ++weakSlotCount_;
+      } else {
+        id = freeWeakSlots_.back();
+        freeWeakSlots_.pop_back();
+      }
+
+      lua_rawgeti(lua_, LUA_REGISTRYINDEX, weakTableRef_);
+      lua_pushvalue(lua_, localReference.val_);
+      lua_rawseti(lua_, -2, static_cast<lua_Integer>(id));
       weakRefCount_++;
     }
-  }
+  });
   return id;
 }
 
 void LuaEngine::removeGlobalOrWeakTable(size_t id, const void* registryToken) {
-  StackFrameScope scope;
-  lua_getglobal(lua_, kLuaGlobalEnvName);
-  auto global = lua_gettop(lua_);
-  lua_rawgetp(lua_, global, registryToken);
-  auto globalTable = lua_gettop(lua_);
-
-  make<Local<Array>>(globalTable).set(id, {});
-
-  // pop globalTable
-  lua_pop(this->lua_, 1);
-
   if (registryToken == kLuaGlobalRegistryToken_) {
+    // luaL_unref is a no-op for LUA_REFNIL
+    luaL_unref(lua_, LUA_REGISTRYINDEX, static_cast<int>(id));
     globalRefCount_--;
   } else {
+    luaStackScope(lua_, [this, id]() {
+      luaEnsureStack(lua_, 2);
+      lua_rawgeti(lua_, LUA_REGISTRYINDEX, weakTableRef_);
+      lua_pushnil(lua_);
+      lua_rawseti(lua_, -2, static_cast<lua_Integer>(id));
+    });
+    freeWeakSlots_.push_back(id);
     weakRefCount_--;
   }
 }
@@ -188,21 +244,22 @@ void LuaEngine::removeGlobalOrWeakTable(size_t id, const void* registryToken) {
 Local<Value> LuaEngine::getGlobalOrWeakTable(size_t index, const void* registryToken) const {
   if (index == 0) return {};
 
-  StackFrameScope stack;
-
-  lua_backend::luaEnsureStack(lua_, 2);
-  lua_getglobal(lua_, kLuaGlobalEnvName);
-  auto global = lua_gettop(lua_);
-  lua_rawgetp(lua_, global, registryToken);
-  auto globalTable = lua_gettop(lua_);
-
-  return stack.returnValue(make<Local<Array>>(globalTable).get(index));
-}
-
-size_t LuaEngine::globalIdCounter() {
-  while (++globalIdCounter_ == 0) {
+  if (registryToken == kLuaGlobalRegistryToken_) {
+    luaEnsureStack(lua_, 1);
+    if (index == kGlobalNilRef) {
+      lua_pushnil(lua_);
+    } else {
+      lua_rawgeti(lua_, LUA_REGISTRYINDEX, static_cast<lua_Integer>(index));
+    }
+  } else {
+    luaEnsureStack(lua_, 2);
+    lua_rawgeti(lua_, LUA_REGISTRYINDEX, weakTableRef_);
+    lua_rawgeti(lua_, -1, static_cast<lua_Integer>(index));
+    // leave only the value on stack
+    lua_remove(lua_, -2);
   }
-  return globalIdCounter_;
+
+  return make<Local<Value>>(lua_gettop(lua_));
 }
 
 Local<Value> LuaEngine::get(const Local<String>& key) {
@@ -280,7 +337,7 @@ void LuaEngine::defineStaticFunctions(const internal::StaticDefine& staticDefine
                    auto fun = static_cast<internal::StaticDefine::FunctionDefine*>(func);
 
                    Tracer trace(arguments.engine(), fun->traceName);
-                   return fun->callback(arguments);
+                   return fun->call(arguments);
                  });
 
     lua_setfield(lua_, tableIndex, fun.name.c_str());
@@ -509,9 +566,9 @@ bool LuaEngine::isInstanceOf(lua_State* lua, const internal::ClassDefineState* c
 
   lua_backend::luaEnsureStack(lua, 1);
   lua_rawgetp(lua, selfIndex, kLuaTableNativeClassDefinePtrToken_);
-  auto ptr = lua_touserdata(lua, -1);
+  auto ptr = static_cast<const internal::ClassDefineState*>(lua_touserdata(lua, -1));
   lua_pop(lua, 1);
-  return ptr == classDefine;
+  return ptr != nullptr && (ptr == classDefine || ptr->isChildOf(classDefine));
 }
 
 void* LuaEngine::getNativeThis(lua_State* lua, const internal::ClassDefineState* classDefine,
@@ -583,6 +640,14 @@ size_t LuaEngine::getHeapSize() {
   return lua_gc(lua_, LUA_GCCOUNT, 0) * 1024;  // NOLINT
 }
 
+HeapStatistics LuaEngine::getHeapStatistics() {
+  HeapStatistics statistics;
+  statistics.usedHeapSize = statistics.totalHeapSize =
+      options_.maxHeapSize != 0 ? allocatedBytes_ : getHeapSize();
+  statistics.heapSizeLimit = options_.maxHeapSize;
+  return statistics;
+}
+
 void LuaEngine::adjustAssociatedMemory(int64_t count) {}
 
 ScriptLanguage LuaEngine::getLanguageType() { return ScriptLanguage::kLua; }
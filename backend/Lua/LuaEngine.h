@@ -17,6 +17,7 @@
 
 #pragma once
 #include <unordered_map>
+#include <vector>
 #include "../../src/Engine.h"
 #include "../../src/Exception.h"
 #include "../../src/Native.h"
@@ -46,21 +47,41 @@ class LuaEngine : public ScriptEngine {
 
   std::mutex lock_;
   std::shared_ptr<::script::utils::MessageQueue> messageQueue_;
-  size_t globalIdCounter_ = 1;
   std::unordered_map<const internal::ClassDefineState*, Global<Object>> nativeDefineRegistry_;
   ::script::internal::GlobalWeakBookkeeping globalWeakBookkeeping_;
   std::unique_ptr<LuaByteBufferDelegate> byteBufferDelegate_;
 
+  // registry ref of the weak-value table that backs Weak slots
+  int weakTableRef_ = 0;
+  // Weak slots are recycled here; luaL_ref can't be used on a weak table since
+  // collected values leave holes that break its length-based allocation
+  std::vector<size_t> freeWeakSlots_;
+  size_t weakSlotCount_ = 0;
+
   size_t globalRefCount_ = 0;
   size_t weakRefCount_ = 0;
   bool isDestroying_ = false;
 
+  // see installLimitedAllocator and applyGcThreshold
+  EngineOptions options_{};
+  lua_Alloc originalAlloc_ = nullptr;
+  void* originalAllocUserData_ = nullptr;
+  size_t allocatedBytes_ = 0;
+  bool nearHeapLimitNotified_ = false;
+
   lua_State* lua_ = nullptr;
 
  public:
+  /**
+   * @param options maxHeapSize -> a counting lua_Alloc wrapping the state's allocator,
+   * nearHeapLimitCallback is called from it. gcThreshold -> the collector pause
+   * (LUA_GCINC, LUA_GCSETPAUSE before 5.4), relative to the heap after initialization.
+   * initialHeapSize is ignored.
+   */
   explicit LuaEngine(std::shared_ptr<::script::utils::MessageQueue> queue = {},
                      const std::function<lua_State*()>& luaStateFactory = {},
-                     std::unique_ptr<LuaByteBufferDelegate> byteBufferDelegate = {});
+                     std::unique_ptr<LuaByteBufferDelegate> byteBufferDelegate = {},
+                     const EngineOptions& options = {});
 
   SCRIPTX_DISALLOW_COPY_AND_MOVE(LuaEngine);
 
@@ -84,6 +105,8 @@ class LuaEngine : public ScriptEngine {
 
   size_t getHeapSize() override;
 
+  HeapStatistics getHeapStatistics() override;
+
   void adjustAssociatedMemory(int64_t count) override;
 
   ScriptLanguage getLanguageType() override;
@@ -110,12 +133,14 @@ class LuaEngine : public ScriptEngine {
  private:
   void initGlobalRegistry();
 
+  void installLimitedAllocator();
+
+  void applyGcThreshold();
+
   Local<Value> get(const char* key);
 
   void set(const char* key, const Local<Value>& value);
 
-  size_t globalIdCounter();
-
   size_t putGlobalOrWeakTable(const Local<Value>& localReference, const void* registryToken);
 
   void removeGlobalOrWeakTable(size_t id, const void* registryToken);
@@ -263,6 +288,13 @@ class LuaByteBufferDelegate {
 
   virtual size_t getByteBufferSize(LuaEngine* engine, const Local<Value>& byteBuffer) = 0;
 
+  /**
+   * get the underlying pointer, without touching the shared_ptr ref-count
+   */
+  virtual void* getByteBufferPointer(LuaEngine* engine, const Local<Value>& byteBuffer) {
+    return getByteBuffer(engine, byteBuffer).get();
+  }
+
   virtual bool isByteBuffer(LuaEngine* engine, const Local<Value>& byteBuffer) = 0;
 };
 
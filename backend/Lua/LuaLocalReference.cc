@@ -424,7 +424,10 @@ size_t Local<ByteBuffer>::byteLength() const {
   return engine->byteBufferDelegate_->getByteBufferSize(engine, asValue());
 }
 
-void* Local<ByteBuffer>::getRawBytes() const { return getRawBytesShared().get(); }
+void* Local<ByteBuffer>::getRawBytes() const {
+  auto engine = lua_backend::currentEngine();
+  return engine->byteBufferDelegate_->getByteBufferPointer(engine, asValue());
+}
 
 std::shared_ptr<void> Local<ByteBuffer>::getRawBytesShared() const {
   auto engine = lua_backend::currentEngine();
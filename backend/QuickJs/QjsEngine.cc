@@ -17,6 +17,16 @@
 
 #include "QjsEngine.h"
 #include <ScriptX/ScriptX.h>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+#include <utility>
+
+#if defined(__APPLE__)
+#include <malloc/malloc.h>
+#elif defined(__linux__) || defined(_WIN32)
+#include <malloc.h>
+#endif
 
 #include <quickjs-libc.h>
 
@@ -27,6 +37,68 @@ JSClassID QjsEngine::kInstanceClassId = 0;
 JSClassID QjsEngine::kFunctionDataClassId = 0;
 static std::once_flag kGlobalQjsClass;
 
+#if !QUICKJS_NG
+namespace {
+
+// same as QuickJs js_def_malloc_usable_size and MALLOC_OVERHEAD
+size_t mallocUsableSize(const void* ptr) {
+#if defined(__APPLE__)
+  return malloc_size(ptr);
+#elif defined(_WIN32)
+  return _msize(const_cast<void*>(ptr));
+#elif defined(__linux__)
+  return malloc_usable_size(const_cast<void*>(ptr));
+#else
+  return 0;
+#endif
+}
+
+constexpr size_t kMallocOverhead = 8;
+
+}  // namespace
+
+// the default allocator of QuickJs, except that each call first applies external memory
+// reported since the last call. the first allocation (of JSRuntime itself) is made on a
+// temporary JSMallocState, nothing can be pending at that time.
+const JSMallocFunctions QjsEngine::kMallocFunctions = {
+    [](JSMallocState* s, size_t size) -> void* {
+      static_cast<QjsEngine*>(s->opaque)->applyExternalMemory(s);
+      if (s->malloc_size + size > s->malloc_limit) return nullptr;
+      auto ptr = std::malloc(size);
+      if (!ptr) return nullptr;
+      s->malloc_count++;
+      s->malloc_size += mallocUsableSize(ptr) + kMallocOverhead;
+      return ptr;
+    },
+    [](JSMallocState* s, void* ptr) {
+      static_cast<QjsEngine*>(s->opaque)->applyExternalMemory(s);
+      if (!ptr) return;
+      s->malloc_count--;
+      s->malloc_size -= mallocUsableSize(ptr) + kMallocOverhead;
+      std::free(ptr);
+    },
+    [](JSMallocState* s, void* ptr, size_t size) -> void* {
+      if (!ptr) {
+        return size == 0 ? nullptr : kMallocFunctions.js_malloc(s, size);
+      }
+      static_cast<QjsEngine*>(s->opaque)->applyExternalMemory(s);
+      auto oldSize = mallocUsableSize(ptr);
+      if (size == 0) {
+        s->malloc_count--;
+        s->malloc_size -= oldSize + kMallocOverhead;
+        std::free(ptr);
+        return nullptr;
+      }
+      if (s->malloc_size + size - oldSize > s->malloc_limit) return nullptr;
+      ptr = std::realloc(ptr, size);
+      if (!ptr) return nullptr;
+      s->malloc_size += mallocUsableSize(ptr) - oldSize;
+      return ptr;
+    },
+    mallocUsableSize};
+#endif
+
+#ifndef QUICK_JS_HAS_SCRIPTX_BYTE_BUFFER_PATCH
 constexpr auto kGetByteBufferInfo = R"(
 (function (val) {
   // NOTE: KEEP SYNC WITH CPP
@@ -79,13 +151,21 @@ constexpr auto kGetByteBufferInfo = R"(
   return [byteBuffer, length, offset, type];
 })
 )";
+#endif
 
-QjsEngine::QjsEngine(std::shared_ptr<utils::MessageQueue> queue, const QjsFactory& factory)
-    : queue_(queue ? std::move(queue) : std::make_shared<utils::MessageQueue>()) {
+QjsEngine::QjsEngine(std::shared_ptr<utils::MessageQueue> queue, const QjsFactory& factory,
+                     const EngineOptions& options)
+    : queue_(queue ? std::move(queue) : std::make_shared<utils::MessageQueue>()),
+      options_(options) {
   if (factory) {
     std::tie(runtime_, context_) = factory();
   } else {
+#if QUICKJS_NG
     runtime_ = JS_NewRuntime();
+#else
+    runtime_ = JS_NewRuntime2(&kMallocFunctions, this);
+    mallocStateAccounting_ = runtime_ != nullptr;
+#endif
     if (runtime_) {
       context_ = JS_NewContext(runtime_);
     }
@@ -95,6 +175,13 @@ QjsEngine::QjsEngine(std::shared_ptr<utils::MessageQueue> queue, const QjsFactor
     throw std::logic_error("QjsEngine: runtime or context is nullptr");
   }
 
+  if (options_.maxHeapSize != 0) {
+    JS_SetMemoryLimit(runtime_, options_.maxHeapSize);
+  }
+  if (options_.gcThreshold != 0) {
+    JS_SetGCThreshold(runtime_, options_.gcThreshold);
+  }
+
   initEngineResource();
 }
 
@@ -134,7 +221,11 @@ void QjsEngine::initEngineResource() {
     if (ptr) {
       auto opaque = static_cast<InstanceClassOpaque*>(ptr);
       // reset the weak reference
-      PauseGc pauseGc(opaque->scriptClassPointer->internalState_.engine);
+      auto engine = opaque->scriptClassPointer->internalState_.engine;
+      PauseGc pauseGc(engine);
+      engine->adjustAssociatedMemory(-static_cast<int64_t>(
+          static_cast<const internal::ClassDefineState*>(opaque->classDefine)
+              ->instanceDefine.instanceSize));
       opaque->scriptClassPointer->internalState_.weakRef_ = JS_UNDEFINED;
       delete opaque->scriptClassPointer;
       delete opaque;
@@ -146,11 +237,14 @@ void QjsEngine::initEngineResource() {
 
   {
     EngineScope scope(this);
+#ifndef QUICK_JS_HAS_SCRIPTX_PATCH
     {
       auto ret = eval("(function(a, b) {return a === b;})");
       helperFunctionStrictEqual_ = qjs_interop::getLocal(ret);
     }
+#endif
 
+#ifndef QUICK_JS_HAS_SCRIPTX_BYTE_BUFFER_PATCH
     {
       auto ret = eval(
           "(function(b) { return b instanceof ArrayBuffer || b instanceof SharedArrayBuffer || "
@@ -162,6 +256,7 @@ void QjsEngine::initEngineResource() {
       auto ret = eval(kGetByteBufferInfo);
       helperFunctionGetByteBufferInfo_ = qjs_interop::getLocal(ret);
     }
+#endif
 
     {
       // TODO(landerl): can we create symbol through C-API? Not yet.
@@ -270,6 +365,8 @@ Local<Value> QjsEngine::eval(const Local<String>& script, const Local<Value>& so
   } else {
     ret = JS_Eval(context_, sh.c_str(), sh.length(), "<unknown>", JS_EVAL_TYPE_GLOBAL);
   }
+  // before checkException, an out of memory error is the most likely time to be near the limit
+  checkNearHeapLimit();
   qjs_backend::checkException(ret);
 
   JSContext* ctx;
@@ -324,10 +421,13 @@ script::Local<script::Value> QjsEngine::evalInPlace(const char* script, size_t s
         return {};
       }
     }
+  } else if (codeCache_) {
+    ret = evalWithCodeCache(script, size, sourceFile.empty() ? "<unknown>" : sourceFile.c_str());
   } else {
     ret = JS_Eval(context_, script, size, sourceFile.empty() ? "<unknown>" : sourceFile.c_str(),
                   JS_EVAL_TYPE_GLOBAL);
   }
+  checkNearHeapLimit();
   qjs_backend::checkException(ret);
 
   triggerTick();
@@ -335,22 +435,218 @@ script::Local<script::Value> QjsEngine::evalInPlace(const char* script, size_t s
   return Local<Value>(ret);
 }
 
+namespace {
+
+/**
+ * A code cache entry is this header, followed by source, sourceFile and the bytecode.
+ * The store key is only a 64-bit hash, so source and sourceFile are kept to verify a hit,
+ * and buildTag rejects bytecode written by another QuickJs build sharing the store.
+ */
+struct CodeCacheEntryHeader {
+  uint32_t magic;
+  uint32_t sourceFileLength;
+  uint64_t buildTag;
+  uint64_t sourceLength;
+};
+
+constexpr uint32_t kCodeCacheEntryMagic = 0x31435153;  // "SQC1"
+
+/**
+ * fingerprint of this QuickJs build's bytecode format (BC_VERSION, opcodes, atoms),
+ * the hash of a fixed script compiled and written by it.
+ */
+uint64_t bytecodeBuildTag(JSContext* context) {
+  static std::once_flag once;
+  static uint64_t tag = 0;
+  std::call_once(once, [context]() {
+    auto obj = JS_Eval(context, "0", 1, "<scriptx>",
+                       JS_EVAL_TYPE_GLOBAL | JS_EVAL_FLAG_COMPILE_ONLY);
+    uint8_t* buffer = nullptr;
+    size_t length = 0;
+    if (!JS_IsException(obj)) {
+      buffer = JS_WriteObject(context, &length, obj, JS_WRITE_OBJ_BYTECODE);
+      JS_FreeValue(context, obj);
+    }
+    if (buffer) {
+      tag = utils::CodeCacheStore::hash(
+          std::string_view(reinterpret_cast<const char*>(buffer), length));
+      js_free(context, buffer);
+    } else {
+      JS_FreeValue(context, JS_GetException(context));
+    }
+  });
+  return tag;
+}
+
+utils::CodeCacheStore::Data makeCodeCacheEntry(uint64_t buildTag, std::string_view source,
+                                               std::string_view sourceFile,
+                                               const uint8_t* bytecode, size_t length) {
+  CodeCacheEntryHeader header{kCodeCacheEntryMagic, static_cast<uint32_t>(sourceFile.size()),
+                              buildTag, source.size()};
+  auto entry = std::make_shared<std::vector<uint8_t>>(sizeof(header) + source.size() +
+                                                      sourceFile.size() + length);
+  auto out = entry->data();
+  std::memcpy(out, &header, sizeof(header));
+  out += sizeof(header);
+  std::memcpy(out, source.data(), source.size());
+  out += source.size();
+  std::memcpy(out, sourceFile.data(), sourceFile.size());
+  out += sourceFile.size();
+  std::memcpy(out, bytecode, length);
+  return entry;
+}
+
+/**
+ * @return the bytecode of entry, or {nullptr, 0} if it wasn't written for this
+ * source, sourceFile and QuickJs build.
+ */
+std::pair<const uint8_t*, size_t> matchCodeCacheEntry(const std::vector<uint8_t>& entry,
+                                                      uint64_t buildTag, std::string_view source,
+                                                      std::string_view sourceFile) {
+  CodeCacheEntryHeader header{};
+  if (entry.size() < sizeof(header)) return {nullptr, 0};
+  std::memcpy(&header, entry.data(), sizeof(header));
+
+  auto prefix = sizeof(header) + source.size() + sourceFile.size();
+  if (header.magic != kCodeCacheEntryMagic || header.buildTag != buildTag ||
+      header.sourceLength != source.size() || header.sourceFileLength != sourceFile.size() ||
+      entry.size() <= prefix) {
+    return {nullptr, 0};
+  }
+
+  auto in = entry.data() + sizeof(header);
+  if (std::memcmp(in, source.data(), source.size()) != 0 ||
+      std::memcmp(in + source.size(), sourceFile.data(), sourceFile.size()) != 0) {
+    return {nullptr, 0};
+  }
+  return {entry.data() + prefix, entry.size() - prefix};
+}
+
+}  // namespace
+
+JSValue QjsEngine::evalWithCodeCache(const char* script, size_t size, const char* sourceFile) {
+  std::string_view source(script, size);
+  std::string_view file(sourceFile);
+  auto key = utils::CodeCacheStore::hash(source, file);
+  auto buildTag = bytecodeBuildTag(context_);
+
+  if (auto data = codeCache_->get(key)) {
+    auto [bytecode, length] = matchCodeCacheEntry(*data, buildTag, source, file);
+    if (bytecode) {
+      auto obj = JS_ReadObject(context_, bytecode, length, JS_READ_OBJ_BYTECODE);
+      if (!JS_IsException(obj)) {
+        ++codeCacheHitCount_;
+        return JS_EvalFunction(context_, obj);
+      }
+      JS_FreeValue(context_, JS_GetException(context_));
+    }
+    // hash collision, bytecode of another build or corrupted, compile again and replace it
+    codeCache_->remove(key);
+  }
+
+  ++codeCacheMissCount_;
+  auto obj = JS_Eval(context_, script, size, sourceFile,
+                     JS_EVAL_TYPE_GLOBAL | JS_EVAL_FLAG_COMPILE_ONLY);
+  if (JS_IsException(obj)) return obj;
+
+  size_t length = 0;
+  auto buffer = JS_WriteObject(context_, &length, obj, JS_WRITE_OBJ_BYTECODE);
+  if (buffer) {
+    codeCache_->put(key, makeCodeCacheEntry(buildTag, source, file, buffer, length));
+    js_free(context_, buffer);
+  } else {
+    // cache is best-effort, still eval the compiled function
+    JS_FreeValue(context_, JS_GetException(context_));
+  }
+  return JS_EvalFunction(context_, obj);
+}
+
 std::shared_ptr<utils::MessageQueue> QjsEngine::messageQueue() { return queue_; }
 
+void QjsEngine::setCodeCacheStore(std::shared_ptr<utils::CodeCacheStore> store) {
+  codeCache_ = std::move(store);
+}
+
+std::shared_ptr<utils::CodeCacheStore> QjsEngine::getCodeCacheStore() const { return codeCache_; }
+
+size_t QjsEngine::codeCacheHitCount() const { return codeCacheHitCount_; }
+
+size_t QjsEngine::codeCacheMissCount() const { return codeCacheMissCount_; }
+
 void QjsEngine::gc() {
   EngineScope scope(this);
   if (isDestroying() || pauseGcCount_ != 0) return;
+  associatedMemory_.onGc();
   JS_RunGC(runtime_);
+  checkNearHeapLimit();
 }
 
 size_t QjsEngine::getHeapSize() {
   EngineScope scope(this);
   JSMemoryUsage usage{};
   JS_ComputeMemoryUsage(runtime_, &usage);
-  return usage.memory_used_size;
+  return usage.memory_used_size + associatedMemory_.total();
+}
+
+HeapStatistics QjsEngine::getHeapStatistics() {
+  EngineScope scope(this);
+  JSMemoryUsage usage{};
+  JS_ComputeMemoryUsage(runtime_, &usage);
+
+  HeapStatistics statistics;
+  statistics.usedHeapSize = static_cast<size_t>(usage.memory_used_size);
+  // includes memory added by reportExternalMemory, which is also part of externalMemory
+  statistics.totalHeapSize = static_cast<size_t>(usage.malloc_size);
+  // -1 when unlimited
+  statistics.heapSizeLimit = usage.malloc_limit > 0 ? static_cast<size_t>(usage.malloc_limit) : 0;
+  statistics.externalMemory = associatedMemory_.total();
+  return statistics;
+}
+
+void QjsEngine::checkNearHeapLimit() {
+  if (!options_.nearHeapLimitCallback || options_.maxHeapSize == 0 || isDestroying()) return;
+
+  JSMemoryUsage usage{};
+  JS_ComputeMemoryUsage(runtime_, &usage);
+  auto near = static_cast<size_t>(usage.malloc_size) >= options_.nearHeapLimit();
+  if (near && !nearHeapLimitNotified_) {
+    options_.nearHeapLimitCallback(this);
+  }
+  nearHeapLimitNotified_ = near;
+}
+
+void QjsEngine::adjustAssociatedMemory(int64_t count) {
+  if (isDestroying()) return;
+  if (associatedMemory_.adjust(count)) {
+    // a no-op while gc is paused, the next adjustment retries
+    gc();
+  }
 }
 
-void QjsEngine::adjustAssociatedMemory(int64_t count) {}
+void QjsEngine::reportExternalMemory(int64_t count) {
+  if (!mallocStateAccounting_) {
+    adjustAssociatedMemory(count);
+    return;
+  }
+  // applied on the next allocation, which is never far away in a running script
+  pendingExternalMemory_ += count;
+  associatedMemory_.adjustReported(count);
+}
+
+#if !QUICKJS_NG
+void QjsEngine::applyExternalMemory(JSMallocState* state) {
+  if (pendingExternalMemory_ == 0) return;
+  // every release was added before, so malloc_size can't underflow
+  state->malloc_size += static_cast<size_t>(pendingExternalMemory_);
+  pendingExternalMemory_ = 0;
+}
+#endif
+
+void QjsEngine::setAssociatedMemoryGcThreshold(size_t threshold) {
+  associatedMemory_.setGcThreshold(threshold);
+}
+
+size_t QjsEngine::getAssociatedMemory() const { return associatedMemory_.total(); }
 
 ScriptLanguage QjsEngine::getLanguageType() { return ScriptLanguage::kJavaScript; }
 
@@ -432,6 +728,8 @@ Local<Object> QjsEngine::newConstructor(
         opaque->scriptClassPointer = instanceTypeToScriptClass(instance);
         opaque->classDefine = classDefine;
         JS_SetOpaque(obj, opaque);
+        engine->adjustAssociatedMemory(
+            static_cast<int64_t>(classDefine->instanceDefine.instanceSize));
 
         return qjs_interop::makeLocal<Value>(obj);
       });
@@ -457,7 +755,7 @@ Local<Object> QjsEngine::newPrototype(const internal::ClassDefineState* define)
 
                                 auto f = static_cast<FuncDef*>(data1);
                                 Tracer tracer(args.engine(), f->traceName);
-                                return (f->callback)(ptr->scriptClassPolymorphicPointer, args);
+                                return f->call(ptr->scriptClassPolymorphicPointer, args);
                               });
     proto.set(f.name, fun);
   }
@@ -524,7 +822,7 @@ void QjsEngine::registerNativeStatic(const Local<Object>& module,
                               [](const Arguments& args, void* data1, void*, bool) {
                                 auto f = static_cast<FuncDef*>(data1);
                                 Tracer trace(args.engine(), f->traceName);
-                                return (f->callback)(args);
+                                return f->call(args);
                               });
     module.set(f.name, fun);
   }
@@ -592,13 +890,18 @@ bool QjsEngine::performIsInstanceOf(const Local<script::Value>& value,
 
 void* QjsEngine::performGetNativeInstance(const Local<script::Value>& value,
                                           const internal::ClassDefineState* classDefine) {
-  if (!performIsInstanceOf(value, classDefine)) {
+  // the opaque records the class define, no need to walk the prototype chain in script.
+  // JS_GetOpaque returns null for non-object or object of other classes.
+  auto ptr = static_cast<InstanceClassOpaque*>(
+      JS_GetOpaque(qjs_interop::peekLocal(value), kInstanceClassId));
+  if (!ptr) return nullptr;
+
+  const auto* objectClassDefine = static_cast<const internal::ClassDefineState*>(ptr->classDefine);
+  if (!objectClassDefine ||
+      (objectClassDefine != classDefine && !objectClassDefine->isChildOf(classDefine))) {
     return nullptr;
   }
-
-  return static_cast<InstanceClassOpaque*>(
-             JS_GetOpaque(qjs_interop::peekLocal(value), kInstanceClassId))
-      ->scriptClassPolymorphicPointer;
+  return ptr->scriptClassPolymorphicPointer;
 }
 
 InstanceClassOpaque* QjsEngine::getAndCheckInstance(const Arguments& args, const void* data2) {
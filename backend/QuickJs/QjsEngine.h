@@ -24,6 +24,8 @@
 
 #include "../../src/Engine.h"
 #include "../../src/Exception.h"
+#include "../../src/utils/AssociatedMemory.h"
+#include "../../src/utils/CodeCache.h"
 #include "../../src/utils/GlobalWeakBookkeeping.hpp"
 #include "../../src/utils/MessageQueue.h"
 #include "QjsHelper.h"
@@ -66,17 +68,45 @@ class QjsEngine : public ScriptEngine {
 
   JSAtom lengthAtom_ = {};
   // QuickJs C API is not enough, we have to use some js helper code.
+  // unused (left empty) when QuickJs is built with the corresponding ScriptX patch.
   JSValue helperFunctionStrictEqual_ = {};
   JSValue helperFunctionIsByteBuffer_ = {};
   JSValue helperFunctionGetByteBufferInfo_ = {};
   JSAtom helperSymbolInternalStore_ = JS_ATOM_NULL;
 
+  std::shared_ptr<utils::CodeCacheStore> codeCache_;
+  std::atomic_size_t codeCacheHitCount_ = 0;
+  std::atomic_size_t codeCacheMissCount_ = 0;
+
+  utils::AssociatedMemoryCounter associatedMemory_{};
+
+#if !QUICKJS_NG
+  // default QuickJs allocator that also folds pendingExternalMemory_ into JSMallocState,
+  // used when the runtime is created by QjsEngine
+  static const JSMallocFunctions kMallocFunctions;
+
+  void applyExternalMemory(JSMallocState* state);
+#endif
+  // true when the runtime uses kMallocFunctions
+  bool mallocStateAccounting_ = false;
+  // bytes reported by reportExternalMemory, not applied to JSMallocState::malloc_size yet
+  int64_t pendingExternalMemory_ = 0;
+
+  EngineOptions options_{};
+  bool nearHeapLimitNotified_ = false;
+
  public:
   using QjsFactory = std::function<std::pair<JSRuntime*, JSContext*>()>;
 
  public:
+  /**
+   * @param options maxHeapSize -> JS_SetMemoryLimit, gcThreshold -> JS_SetGCThreshold,
+   * initialHeapSize is ignored.
+   * nearHeapLimitCallback is checked after each eval and gc, which costs a
+   * JS_ComputeMemoryUsage walk of the heap, so only set it when needed.
+   */
   explicit QjsEngine(std::shared_ptr<::script::utils::MessageQueue> queue = nullptr,
-                     const QjsFactory& factory = nullptr);
+                     const QjsFactory& factory = nullptr, const EngineOptions& options = {});
 
   SCRIPTX_DISALLOW_COPY_AND_MOVE(QjsEngine);
 
@@ -107,12 +137,52 @@ class QjsEngine : public ScriptEngine {
 
   size_t getHeapSize() override;
 
+  HeapStatistics getHeapStatistics() override;
+
   void adjustAssociatedMemory(int64_t count) override;
 
   ScriptLanguage getLanguageType() override;
 
   std::string getEngineVersion() override;
 
+  /**
+   * Enable bytecode cache for evalInPlace of source code (sourceFile is empty or ends with ".js").
+   *
+   * On cache miss the source is compiled and the bytecode (JS_WriteObject) is put into store,
+   * later evals of the same content, from this or other engines sharing the store,
+   * load the bytecode via JS_ReadObject and skip parsing.
+   *
+   * @param store nullptr to disable, ex: std::make_shared<utils::LruCodeCacheStore>()
+   */
+  void setCodeCacheStore(std::shared_ptr<utils::CodeCacheStore> store);
+
+  std::shared_ptr<utils::CodeCacheStore> getCodeCacheStore() const;
+
+  size_t codeCacheHitCount() const;
+
+  size_t codeCacheMissCount() const;
+
+  /**
+   * Native memory owned by a script object, ByteBuffers backed by native memory report
+   * automatically. When the runtime is created by QjsEngine it's added to the malloc state of
+   * the runtime, so that QuickJs schedules the GC (and applies the memory limit) as if it had
+   * allocated it. Otherwise (a QjsFactory runtime, or quickjs-ng) it falls back to
+   * adjustAssociatedMemory.
+   */
+  void reportExternalMemory(int64_t count);
+
+  /**
+   * Native memory reported via adjustAssociatedMemory (ScriptClass instances report
+   * automatically).
+   * QuickJs GC knows nothing about it, so a GC is run every time threshold bytes
+   * have been associated since the last GC.
+   *
+   * @param threshold bytes, 0 to disable, default utils::AssociatedMemoryCounter::kDefaultGcThreshold
+   */
+  void setAssociatedMemoryGcThreshold(size_t threshold);
+
+  size_t getAssociatedMemory() const;
+
  protected:
   ~QjsEngine() override;
 
@@ -151,6 +221,10 @@ class QjsEngine : public ScriptEngine {
 
   void extendLifeTimeToNextLoop(JSValue value);
 
+  void checkNearHeapLimit();
+
+  JSValue evalWithCodeCache(const char* script, size_t size, const char* sourceFile);
+
   template <typename T, typename... Args>
   static T make(Args&&... args) {
     return T(std::forward<Args>(args)...);
@@ -156,6 +156,12 @@ bool Local<Value>::isArray() const { return JS_IsArray(qjs_backend::currentConte
 #endif
 
 bool Local<Value>::isByteBuffer() const {
+#ifdef QUICK_JS_HAS_SCRIPTX_BYTE_BUFFER_PATCH
+  uint8_t* data;
+  size_t size;
+  int type;
+  return JS_GetByteBufferInfo(qjs_backend::currentContext(), val_, &data, &size, &type) == 0;
+#else
   if (!isObject()) return false;
 
   auto& engine = qjs_backend::currentEngine();
@@ -164,6 +170,7 @@ bool Local<Value>::isByteBuffer() const {
   auto fun = qjs_interop::makeLocal<Function>(
       qjs_backend::dupValue(engine.helperFunctionIsByteBuffer_, context));
   return fun.call({}, *this).asBoolean().value();
+#endif
 }
 
 bool Local<Value>::isObject() const { return JS_IsObject(val_); }
@@ -426,6 +433,50 @@ ByteBufferState& ByteBufferState::operator=(JSValue what) {
   return *this;
 }
 
+#ifdef QUICK_JS_HAS_SCRIPTX_BYTE_BUFFER_PATCH
+static ByteBuffer::Type toByteBufferType(int type) {
+  switch (type) {
+    case JS_BYTE_BUFFER_INT8:
+      return ByteBuffer::Type::kInt8;
+    case JS_BYTE_BUFFER_UINT8:
+      return ByteBuffer::Type::kUint8;
+    case JS_BYTE_BUFFER_INT16:
+      return ByteBuffer::Type::kInt16;
+    case JS_BYTE_BUFFER_UINT16:
+      return ByteBuffer::Type::kUint16;
+    case JS_BYTE_BUFFER_INT32:
+      return ByteBuffer::Type::kInt32;
+    case JS_BYTE_BUFFER_UINT32:
+      return ByteBuffer::Type::kUint32;
+    case JS_BYTE_BUFFER_INT64:
+      return ByteBuffer::Type::kInt64;
+    case JS_BYTE_BUFFER_UINT64:
+      return ByteBuffer::Type::kUint64;
+    case JS_BYTE_BUFFER_FLOAT32:
+      return ByteBuffer::Type::kFloat32;
+    case JS_BYTE_BUFFER_FLOAT64:
+      return ByteBuffer::Type::kFloat64;
+    default:
+      return ByteBuffer::Type::kUnspecified;
+  }
+}
+
+void ByteBufferState::fillTypeAndSize() const {
+  if (size_ == kNoSize) {
+    uint8_t* ptr;
+    size_t size;
+    int type;
+    if (JS_GetByteBufferInfo(qjs_backend::currentContext(), val_, &ptr, &size, &type) != 0 ||
+        ptr == nullptr) {
+      throw Exception("can't get ArrayBuffer pointer");
+    }
+
+    pointer_ = ptr;
+    size_ = size;
+    type_ = toByteBufferType(type);
+  }
+}
+#else
 void ByteBufferState::fillTypeAndSize() const {
   if (size_ == kNoSize) {
     auto& engine = qjs_backend::currentEngine();
@@ -453,6 +504,7 @@ void ByteBufferState::fillTypeAndSize() const {
     size_ = length;
   }
 }
+#endif
 
 void swap(ByteBufferState& lhs, ByteBufferState& rhs) {
   using std::swap;
@@ -170,20 +170,36 @@ Local<script::ByteBuffer> ByteBuffer::newByteBuffer(void* nativeBuffer, size_t s
   return qjs_interop::makeLocal<ByteBuffer>(ab);
 }
 
+namespace {
+
+// native memory not allocated by QuickJs, see QjsEngine::reportExternalMemory
+struct SharedByteBufferHolder {
+  std::shared_ptr<void> buffer;
+  qjs_backend::QjsEngine* engine;
+  size_t size;
+};
+
+}  // namespace
+
 Local<ByteBuffer> ByteBuffer::newByteBuffer(std::shared_ptr<void> nativeBuffer, size_t size) {
   auto ptr = nativeBuffer.get();
-  auto sharedPtrPtr = std::make_unique<std::shared_ptr<void>>(std::move(nativeBuffer));
-  auto opaque = sharedPtrPtr.get();
+  auto engine = &qjs_backend::currentEngine();
+  auto holder = std::make_unique<SharedByteBufferHolder>(
+      SharedByteBufferHolder{std::move(nativeBuffer), engine, size});
+  auto opaque = holder.get();
 
   auto ab = JS_NewArrayBuffer(
       qjs_backend::currentContext(), static_cast<uint8_t*>(ptr), size,
       [](JSRuntime*, void* opaque, void* /*ptr*/) {
-        delete static_cast<std::shared_ptr<void>*>(opaque);
+        auto holder = static_cast<SharedByteBufferHolder*>(opaque);
+        holder->engine->reportExternalMemory(-static_cast<int64_t>(holder->size));
+        delete holder;
       },
       opaque, false);
   qjs_backend::checkException(ab);
 
-  sharedPtrPtr.release();  // NOLINT(bugprone-unused-return-value)
+  holder.release();  // NOLINT(bugprone-unused-return-value)
+  engine->reportExternalMemory(static_cast<int64_t>(size));
   return qjs_interop::makeLocal<ByteBuffer>(ab);
 }
 
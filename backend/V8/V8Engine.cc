@@ -25,12 +25,26 @@
 namespace script::v8_backend {
 
 // create a master engine (opposite to slave engine)
-V8Engine::V8Engine(std::shared_ptr<utils::MessageQueue> mq) : V8Engine(std::move(mq), nullptr) {}
+V8Engine::V8Engine(std::shared_ptr<utils::MessageQueue> mq)
+    : V8Engine(std::move(mq), std::function<v8::Isolate*()>(), nullptr) {}
 
 V8Engine::V8Engine(std::shared_ptr<utils::MessageQueue> mq,
                    const std::function<v8::Isolate*()>& isolateFactory)
+    : V8Engine(std::move(mq), isolateFactory, nullptr) {}
+
+V8Engine::V8Engine(std::shared_ptr<utils::MessageQueue> mq, Snapshot snapshot)
+    : V8Engine(std::move(mq), std::function<v8::Isolate*()>(), std::move(snapshot)) {}
+
+V8Engine::V8Engine(std::shared_ptr<utils::MessageQueue> mq, const EngineOptions& options)
+    : V8Engine(std::move(mq), std::function<v8::Isolate*()>(), nullptr, options) {}
+
+V8Engine::V8Engine(std::shared_ptr<utils::MessageQueue> mq,
+                   const std::function<v8::Isolate*()>& isolateFactory, Snapshot snapshot,
+                   const EngineOptions& options)
     : v8Platform_(V8Platform::getPlatform()),
-      messageQueue_(mq ? std::move(mq) : std::make_shared<utils::MessageQueue>()) {
+      messageQueue_(mq ? std::move(mq) : std::make_shared<utils::MessageQueue>()),
+      snapshot_(std::move(snapshot)),
+      options_(options) {
   // create isolation
   if (isolateFactory) {
     isolate_ = isolateFactory();
@@ -38,10 +52,42 @@ V8Engine::V8Engine(std::shared_ptr<utils::MessageQueue> mq,
     v8::Isolate::CreateParams createParams;
     allocator_.reset(v8::ArrayBuffer::Allocator::NewDefaultAllocator());
     createParams.array_buffer_allocator = allocator_.get();
+    if (snapshot_) {
+      // v8 reads the blob lazily, snapshot_ is kept alive until isolate is disposed
+      createParams.snapshot_blob = snapshot_.get();
+    }
+    if (options_.maxHeapSize != 0) {
+#if SCRIPTX_V8_VERSION_GE(7, 9)
+      createParams.constraints.ConfigureDefaultsFromHeapSize(options_.initialHeapSize,
+                                                             options_.maxHeapSize);
+#else
+      // in MB before 7.9
+      createParams.constraints.set_max_old_space_size(
+          static_cast<int>(options_.maxHeapSize / 1024 / 1024));
+#endif
+    } else if (options_.initialHeapSize != 0) {
+#if SCRIPTX_V8_VERSION_GE(7, 9)
+      // ConfigureDefaultsFromHeapSize(initial, 0) would cap the heap at initial,
+      // only grow the starting old space and keep v8's default limit.
+      createParams.constraints.set_initial_old_generation_size_in_bytes(options_.initialHeapSize);
+#endif
+    }
     isolate_ = v8::Isolate::New(createParams);
   }
   v8Platform_->addEngineInstance(isolate_, this);
 
+  if (options_.nearHeapLimitCallback) {
+    isolate_->AddNearHeapLimitCallback(
+        [](void* data, size_t currentHeapLimit, size_t /*initialHeapLimit*/) -> size_t {
+          auto engine = static_cast<V8Engine*>(data);
+          engine->options_.nearHeapLimitCallback(engine);
+          if (engine->nearHeapLimitRaised_) return currentHeapLimit;
+          engine->nearHeapLimitRaised_ = true;
+          return currentHeapLimit + currentHeapLimit / 10;
+        },
+        this);
+  }
+
   isolate_->SetCaptureStackTraceForUncaughtExceptions(true);
 
   initContext();
@@ -132,6 +178,68 @@ UniqueEnginePtr V8Engine::newSlaveEngine() { return UniqueEnginePtr(new V8Engine
 
 std::shared_ptr<script::utils::MessageQueue> V8Engine::messageQueue() { return messageQueue_; }
 
+V8Engine::Snapshot V8Engine::createSnapshot(const std::vector<std::string>& bootstrapScripts) {
+  // make sure v8 is initialized
+  auto platform = V8Platform::getPlatform();
+  (void)platform;
+
+#if SCRIPTX_V8_VERSION_GE(11, 9)
+  v8::Isolate::CreateParams createParams;
+  std::unique_ptr<v8::ArrayBuffer::Allocator> allocator(
+      v8::ArrayBuffer::Allocator::NewDefaultAllocator());
+  createParams.array_buffer_allocator = allocator.get();
+  v8::SnapshotCreator creator(createParams);
+#else
+  v8::SnapshotCreator creator;
+#endif
+
+  auto isolate = creator.GetIsolate();
+  {
+    v8::Isolate::Scope isolateScope(isolate);
+    v8::HandleScope handleScope(isolate);
+    auto context = v8::Context::New(isolate);
+    v8::Context::Scope contextScope(context);
+
+    for (auto& script : bootstrapScripts) {
+      v8::TryCatch tryCatch(isolate);
+      v8::Local<v8::String> source;
+      v8::Local<v8::Script> compiled;
+      if (!v8::String::NewFromUtf8(isolate, script.c_str(), v8::NewStringType::kNormal,
+                                   static_cast<int>(script.length()))
+               .ToLocal(&source) ||
+          !v8::Script::Compile(context, source).ToLocal(&compiled) ||
+          compiled->Run(context).IsEmpty()) {
+        std::string message = "can't create snapshot";
+        if (tryCatch.HasCaught()) {
+          v8::String::Utf8Value what(isolate, tryCatch.Exception());
+          if (*what) message.append(": ").append(*what, what.length());
+        }
+        throw Exception(message);
+      }
+    }
+    creator.SetDefaultContext(context);
+  }
+
+  auto blob = creator.CreateBlob(v8::SnapshotCreator::FunctionCodeHandling::kKeep);
+  if (blob.data == nullptr) {
+    throw Exception("can't create snapshot");
+  }
+  return Snapshot(new v8::StartupData(blob), [](const v8::StartupData* data) {
+    delete[] data->data;
+    delete data;
+  });
+}
+
+void V8Engine::setCodeCacheStore(std::shared_ptr<utils::CodeCacheStore> store) {
+  codeCache_ = std::move(store);
+}
+
+std::shared_ptr<utils::CodeCacheStore> V8Engine::getCodeCacheStore() const { return codeCache_; }
+
+size_t V8Engine::codeCacheHitCount() const { return codeCacheHitCount_; }
+
+size_t V8Engine::codeCacheMissCount() const { return codeCacheMissCount_; }
+
 ScriptLanguage V8Engine::getLanguageType() { return ScriptLanguage::kJavaScript; }
 
 std::string V8Engine::getEngineVersion() { return std::string("V8 ") + v8::V8::GetVersion(); }
@@ -157,18 +265,62 @@ Local<Value> V8Engine::eval(const Local<String>& script, const Local<Value>& sou
   if (scriptString.IsEmpty() || scriptString->IsNullOrUndefined()) {
     throw Exception("can't eval script");
   }
+  auto hasSourceFile = !sourceFile.isNull() && sourceFile.isString();
   v8::ScriptOrigin origin(
 #if SCRIPTX_V8_VERSION_BETWEEN(9, 0, 12, 0)
       // V8 9.0 add isolate param for external API
       // V8 12.1 deprecated the isolate version, and introduced the one without isolation
       isolate_,
 #endif
-      sourceFile.isNull() || !sourceFile.isString() ? v8::Local<v8::String>()
-                                                    : toV8(isolate_, sourceFile.asString()));
-  v8::MaybeLocal<v8::Script> maybeScript = v8::Script::Compile(context, scriptString, &origin);
+      hasSourceFile ? toV8(isolate_, sourceFile.asString()) : v8::Local<v8::String>());
+
+  if (!codeCache_) {
+    v8::MaybeLocal<v8::Script> maybeScript = v8::Script::Compile(context, scriptString, &origin);
+    v8_backend::checkException(tryCatch);
+    auto maybeResult = maybeScript.ToLocalChecked()->Run(context);
+    v8_backend::checkException(tryCatch);
+    return make<Local<Value>>(maybeResult.ToLocalChecked());
+  }
+
+  v8::String::Utf8Value utf8(isolate_, scriptString);
+  auto key = utils::CodeCacheStore::hash(std::string_view(*utf8, utf8.length()),
+                                         hasSourceFile ? sourceFile.asString().toString() : "");
+
+  // the buffer is not owned by CachedData, hold it until compile is done
+  auto data = codeCache_->get(key);
+  auto cachedData =
+      data ? new v8::ScriptCompiler::CachedData(data->data(), static_cast<int>(data->size()),
+                                                v8::ScriptCompiler::CachedData::BufferNotOwned)
+           : nullptr;
+  // source takes the ownership of cachedData
+  v8::ScriptCompiler::Source source(scriptString, origin, cachedData);
+  auto maybeScript = v8::ScriptCompiler::Compile(
+      context, &source,
+      data ? v8::ScriptCompiler::kConsumeCodeCache : v8::ScriptCompiler::kNoCompileOptions);
   v8_backend::checkException(tryCatch);
-  auto maybeResult = maybeScript.ToLocalChecked()->Run(context);
+  auto compiled = maybeScript.ToLocalChecked();
+
+  auto hit = data && !source.GetCachedData()->rejected;
+  if (hit) {
+    ++codeCacheHitCount_;
+  } else {
+    // cache is missing or rejected (ex: V8 version or flags changed), produce a new one
+    ++codeCacheMissCount_;
+    if (data) codeCache_->remove(key);
+  }
+
+  auto maybeResult = compiled->Run(context);
   v8_backend::checkException(tryCatch);
+
+  if (!hit) {
+    // create after run, so that lazily compiled functions are included
+    std::unique_ptr<v8::ScriptCompiler::CachedData> newData(
+        v8::ScriptCompiler::CreateCodeCache(compiled->GetUnboundScript()));
+    if (newData && newData->length > 0) {
+      codeCache_->put(key, std::make_shared<std::vector<uint8_t>>(
+                               newData->data, newData->data + newData->length));
+    }
+  }
   return make<Local<Value>>(maybeResult.ToLocalChecked());
 }
 
@@ -241,7 +393,7 @@ void V8Engine::registerNativeClassStatic(v8::Local<v8::FunctionTemplate> funcT,
           Tracer trace(engine, funcDef->traceName);
 
           try {
-            auto returnVal = (funcDef->callback)(extractV8Arguments(engine, info));
+            auto returnVal = funcDef->call(extractV8Arguments(engine, info));
             info.GetReturnValue().Set(v8_backend::V8Engine::toV8(info.GetIsolate(), returnVal));
           } catch (Exception& e) {
             v8_backend::rethrowException(e);
@@ -271,6 +423,19 @@ size_t V8Engine::getHeapSize() {
          heapStatistics.external_memory();
 }
 
+HeapStatistics V8Engine::getHeapStatistics() {
+  EngineScope engineScope(this);
+  v8::HeapStatistics heapStatistics;
+  isolate_->GetHeapStatistics(&heapStatistics);
+
+  HeapStatistics statistics;
+  statistics.usedHeapSize = heapStatistics.used_heap_size();
+  statistics.totalHeapSize = heapStatistics.total_heap_size();
+  statistics.heapSizeLimit = heapStatistics.heap_size_limit();
+  statistics.externalMemory = heapStatistics.external_memory();
+  return statistics;
+}
+
 void V8Engine::adjustAssociatedMemory(int64_t count) {
   if (isDestroying()) return;
   EngineScope engineScope(this);
@@ -535,7 +700,7 @@ void V8Engine::registerNativeClassInstance(v8::Local<v8::FunctionTemplate> funcT
 
           Tracer trace(engine, ptr->traceName);
           try {
-            auto returnVal = (ptr->callback)(thiz, extractV8Arguments(engine, info));
+            auto returnVal = ptr->call(thiz, extractV8Arguments(engine, info));
             info.GetReturnValue().Set(v8_backend::V8Engine::toV8(info.GetIsolate(), returnVal));
           } catch (Exception& e) {
             v8_backend::rethrowException(e);
@@ -18,11 +18,13 @@
 #pragma once
 
 #include <unordered_map>
+#include <vector>
 #include "../../src/Engine.h"
 #include "../../src/Native.h"
 #include "../../src/Reference.h"
 #include "../../src/Scope.h"
 #include "../../src/Value.h"
+#include "../../src/utils/CodeCache.h"
 #include "../../src/utils/GlobalWeakBookkeeping.hpp"
 #include "V8Helper.h"
 #include "V8Platform.h"
@@ -32,6 +34,13 @@ namespace script::v8_backend {
 class InspectorClient;
 
 class V8Engine : public ::script::ScriptEngine {
+ public:
+  /**
+   * V8 startup snapshot, see V8Engine::createSnapshot
+   */
+  using Snapshot = std::shared_ptr<const v8::StartupData>;
+
+ private:
   struct ManagedObject {
     V8Engine* engine;
     void* data;
@@ -66,6 +75,16 @@ class V8Engine : public ::script::ScriptEngine {
 
   internal::GlobalWeakBookkeeping globalWeakBookkeeping_;
 
+  // must outlive isolate_
+  Snapshot snapshot_;
+
+  std::shared_ptr<utils::CodeCacheStore> codeCache_;
+  size_t codeCacheHitCount_ = 0;
+  size_t codeCacheMissCount_ = 0;
+
+  EngineOptions options_{};
+  bool nearHeapLimitRaised_ = false;
+
   // create a slave engine
   explicit V8Engine(V8Engine* masterEngine);
 
@@ -81,6 +100,10 @@ class V8Engine : public ::script::ScriptEngine {
   explicit V8Engine(std::shared_ptr<utils::MessageQueue> messageQueue,
                     const std::function<v8::Isolate*()>& isolateFactory);
 
+  V8Engine(std::shared_ptr<utils::MessageQueue> messageQueue,
+           const std::function<v8::Isolate*()>& isolateFactory, Snapshot snapshot,
+           const EngineOptions& options = {});
+
   ~V8Engine() override;
 
  public:
@@ -100,6 +123,35 @@ class V8Engine : public ::script::ScriptEngine {
   explicit V8Engine(std::shared_ptr<utils::MessageQueue> messageQueue, v8::Isolate* isolate,
                     v8::Local<v8::Context> context, bool addGlobalEngineScope = true);
 
+  /**
+   * Create an engine whose default context is deserialized from snapshot,
+   * so the bootstrap scripts don't need to be parsed and run again.
+   * Native classes are not part of the snapshot, register them as usual.
+   */
+  V8Engine(std::shared_ptr<utils::MessageQueue> messageQueue, Snapshot snapshot);
+
+  /**
+   * Create an engine with memory options.
+   * initialHeapSize and maxHeapSize -> ResourceConstraints::ConfigureDefaultsFromHeapSize,
+   * nearHeapLimitCallback -> Isolate::AddNearHeapLimitCallback, gcThreshold is ignored.
+   *
+   * Note: V8 aborts the process when the heap is out of memory, so on the first call of
+   * nearHeapLimitCallback the limit is raised by 10% to leave room to stop the script,
+   * ie. via v8::Isolate::TerminateExecution.
+   */
+  V8Engine(std::shared_ptr<utils::MessageQueue> messageQueue, const EngineOptions& options);
+
+  /**
+   * Run bootstrapScripts in a fresh context and capture it with v8::SnapshotCreator.
+   * The returned snapshot can be shared by engines on any thread.
+   *
+   * Note: only pure js state is captured, scripts must not depend on native classes or
+   * functions registered by ScriptX. (which point to native callbacks and can't be serialized
+   * without an external references table)
+   * On script error, an Exception is thrown.
+   */
+  static Snapshot createSnapshot(const std::vector<std::string>& bootstrapScripts);
+
   void destroy() noexcept override;
 
   bool isDestroying() const override;
@@ -130,12 +182,31 @@ class V8Engine : public ::script::ScriptEngine {
 
   size_t getHeapSize() override;
 
+  HeapStatistics getHeapStatistics() override;
+
   void adjustAssociatedMemory(int64_t count) override;
 
   ScriptLanguage getLanguageType() override;
 
   std::string getEngineVersion() override;
 
+  /**
+   * Enable code cache for eval.
+   *
+   * On cache miss the script is compiled from source and its v8::ScriptCompiler::CachedData is put
+   * into store after first run, later evals of the same content, from this or other engines sharing
+   * the store, compile with kConsumeCodeCache. Rejected cache data is replaced.
+   *
+   * @param store nullptr to disable, ex: std::make_shared<utils::LruCodeCacheStore>()
+   */
+  void setCodeCacheStore(std::shared_ptr<utils::CodeCacheStore> store);
+
+  std::shared_ptr<utils::CodeCacheStore> getCodeCacheStore() const;
+
+  size_t codeCacheHitCount() const;
+
+  size_t codeCacheMissCount() const;
+
  protected:
   void performRegisterNativeClass(
       internal::TypeIndex typeIndex, const internal::ClassDefineState* classDefine,
@@ -93,7 +93,7 @@ void WasmEngine::defineStatic(const Local<Object>& obj, const internal::StaticDe
         [](const Arguments& args, void* data, void*) -> Local<Value> {
           auto fun = static_cast<internal::StaticDefine::FunctionDefine*>(data);
           Tracer trace(args.engineAs<WasmEngine>(), fun->traceName);
-          return fun->callback(args);
+          return fun->call(args);
         },
         &func);
     obj.set(func.name, Local<Value>(fi));
@@ -241,7 +241,7 @@ void WasmEngine::defineInstance(const internal::ClassDefineState* classDefine,
           auto ins = verifyAndGetInstance(classDefine, args.thiz().val_);
 
           Tracer trace(args.engine(), func.traceName);
-          return func.callback(ins, args);
+          return func.call(ins, args);
         },
         classDefine, &func);
 
@@ -54,6 +54,19 @@ TEST_CASE("Test", "") {
     }
   };
 
+  BENCHMARK("Load prepared") {
+    auto engine = createEngine();
+    {
+      try {
+        script::EngineScope enter(engine.get());
+        // only the first engine compiles, the rest share the process-wide prepared script
+        auto hermes = script::EngineScope::currentEngineAs<script::hermes_backend::HermesEngine>();
+        const auto out = hermes->evaluatePrepared(hermes->prepare(content, "123"));
+      } catch (...) {
+      }
+    }
+  };
+
   p = std::filesystem::path(bytecodePath);
   file = std::ifstream(p, std::ios::in | std::ios::binary);
   if (!file.is_open()) {
@@ -16,14 +16,126 @@
  */
 
 #include <ScriptX/ScriptX.h>
+#include <atomic>
+#include <deque>
+#include <list>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace script {
 
+namespace internal {
+
+struct InternedKeys {
+  // runtime keys longer than this are rarely constant, don't cache them
+  static constexpr size_t kMaxRuntimeKeyLength = 64;
+  // bound memory of keys built from dynamic content, least recently used ones are evicted
+  static constexpr size_t kMaxRuntimeKeyCount = 1024;
+
+  // indexed by InternedKey::id(), deque keeps Global in place when growing
+  std::deque<Global<String>> slots;
+
+  struct RuntimeKey {
+    std::string name;
+    Global<String> string;
+  };
+  // front is the most recently used, key of runtimeKeyIndex points into RuntimeKey::name
+  std::list<RuntimeKey> runtimeKeys;
+  std::unordered_map<std::string_view, std::list<RuntimeKey>::iterator> runtimeKeyIndex;
+  // keys seen once and not cached yet, a key is only cached on its second miss so one-off keys
+  // don't evict hot ones. cleared when full, which only delays admission of a key once more.
+  std::unordered_set<std::string> candidateKeys;
+};
+
+Local<String> makePropertyKey(std::string_view key) {
+  auto engine = EngineScope::currentEngine();
+  if (engine == nullptr) {
+    return String::newString(key);
+  }
+  return engine->getInternedKey(key);
+}
+
+InternedKey::InternedKey(std::string name) : name_(std::move(name)) {
+  static std::atomic<size_t> idCounter{0};
+  id_ = idCounter++;
+}
+
+}  // namespace internal
+
 void ScriptEngine::setData(std::shared_ptr<void> arbitraryData) {
   userData_ = std::move(arbitraryData);
 }
 
-void ScriptEngine::destroyUserData() { userData_.reset(); }
+void ScriptEngine::destroyUserData() {
+  userData_.reset();
+  internedKeys_.reset();
+}
+
+Local<String> ScriptEngine::getInternedKey(const internal::InternedKey& key) {
+  if (isDestroying()) {
+    // cache is already released, don't hold new references
+    return String::newString(key.name());
+  }
+  if (!internedKeys_) {
+    internedKeys_ = std::make_shared<internal::InternedKeys>();
+  }
+  auto& slots = internedKeys_->slots;
+  if (key.id() >= slots.size()) {
+    slots.resize(key.id() + 1);
+  }
+  auto& slot = slots[key.id()];
+  if (slot.isEmpty()) {
+    auto str = String::newString(key.name());
+    slot = str;
+    return str;
+  }
+  return slot.get();
+}
+
+Local<String> ScriptEngine::getInternedKey(std::string_view key) {
+  using internal::InternedKeys;
+  if (key.size() > InternedKeys::kMaxRuntimeKeyLength || isDestroying()) {
+    return String::newString(key);
+  }
+  if (!internedKeys_) {
+    internedKeys_ = std::make_shared<InternedKeys>();
+  }
+
+  auto& keys = *internedKeys_;
+  auto it = keys.runtimeKeyIndex.find(key);
+  if (it != keys.runtimeKeyIndex.end()) {
+    keys.runtimeKeys.splice(keys.runtimeKeys.begin(), keys.runtimeKeys, it->second);
+    return it->second->string.get();
+  }
+
+  auto str = String::newString(key);
+  auto candidate = keys.candidateKeys.find(std::string(key));
+  if (candidate == keys.candidateKeys.end()) {
+    if (keys.candidateKeys.size() >= InternedKeys::kMaxRuntimeKeyCount) {
+      keys.candidateKeys.clear();
+    }
+    keys.candidateKeys.emplace(key);
+    return str;
+  }
+  keys.candidateKeys.erase(candidate);
+
+  if (keys.runtimeKeys.size() >= InternedKeys::kMaxRuntimeKeyCount) {
+    keys.runtimeKeyIndex.erase(keys.runtimeKeys.back().name);
+    keys.runtimeKeys.pop_back();
+  }
+  auto& entry = keys.runtimeKeys.emplace_front();
+  entry.name = key;
+  entry.string = str;
+  keys.runtimeKeyIndex.emplace(entry.name, keys.runtimeKeys.begin());
+  return str;
+}
+
+HeapStatistics ScriptEngine::getHeapStatistics() {
+  HeapStatistics statistics;
+  statistics.usedHeapSize = statistics.totalHeapSize = getHeapSize();
+  return statistics;
+}
 
 void ScriptEngine::registerNativeClass(const script::NativeRegister& nativeRegister) {
   nativeRegister.registerNativeClass(this);
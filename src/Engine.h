@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string_view>
 #include <unordered_map>
@@ -29,11 +30,82 @@
 
 namespace script {
 
+namespace internal {
+
+/**
+ * A property key known ahead (ie. field name of a struct),
+ * the String is created once per engine and reused afterwards, see ScriptEngine::getInternedKey.
+ *
+ * InternedKey should have static storage, each one takes a slot in every engine it's used.
+ */
+class InternedKey {
+  size_t id_;
+  std::string name_;
+
+ public:
+  explicit InternedKey(std::string name);
+
+  SCRIPTX_DISALLOW_COPY_AND_MOVE(InternedKey);
+
+  size_t id() const { return id_; }
+
+  const std::string& name() const { return name_; }
+};
+
+struct InternedKeys;
+
+}  // namespace internal
+
+class ScriptEngine;
+
+/**
+ * detailed heap numbers of an engine, see ScriptEngine::getHeapStatistics.
+ * fields a backend can't provide are left 0.
+ */
+struct HeapStatistics {
+  // bytes used by live script objects
+  size_t usedHeapSize = 0;
+  // bytes currently reserved by the script heap
+  size_t totalHeapSize = 0;
+  // max heap size the engine is limited to, 0 for unlimited
+  size_t heapSizeLimit = 0;
+  // native memory outside of the script heap, ie. reported by adjustAssociatedMemory
+  size_t externalMemory = 0;
+  // number of garbage collections run so far
+  size_t gcCount = 0;
+};
+
+/**
+ * Memory options of an engine, given to the backend engine's constructor.
+ * A 0 value keeps the engine default, see docs/en/Performance.md for how each backend maps them.
+ */
+struct EngineOptions {
+  // hard limit of the script heap, allocations beyond it fail with an out of memory error
+  size_t maxHeapSize = 0;
+
+  // heap size reserved up front
+  size_t initialHeapSize = 0;
+
+  // heap growth (bytes) that triggers a garbage collection
+  size_t gcThreshold = 0;
+
+  /**
+   * called when heap usage is close to maxHeapSize (see nearHeapLimit),
+   * again only after usage has dropped below it.
+   * It may be called in the middle of an allocation or a gc, so it must not throw
+   * nor call script API; record the state and react later (ie. destroy the engine).
+   */
+  std::function<void(ScriptEngine* engine)> nearHeapLimitCallback;
+
+  size_t nearHeapLimit() const { return maxHeapSize / 10 * 9; }
+};
+
 class ScriptEngine {
  protected:
   std::unordered_map<internal::TypeIndex, const internal::ClassDefineState*> classDefineRegistry_{};
   std::unordered_set<const internal::ClassDefineState*> staticClassDefineRegistry_{};
   std::shared_ptr<void> userData_{};
+  std::shared_ptr<internal::InternedKeys> internedKeys_{};
 
  public:
   explicit ScriptEngine(std::shared_ptr<utils::MessageQueue> messageQueue = {}) {}
@@ -77,7 +149,7 @@ class ScriptEngine {
    */
   template <typename StringLike, StringLikeConcept(StringLike)>
   Local<Value> get(StringLike&& keyStringLike) {
-    return get(String::newString(std::forward<StringLike>(keyStringLike)));
+    return get(internal::makePropertyKey(std::forward<StringLike>(keyStringLike)));
   }
 
   /*
@@ -206,6 +278,12 @@ class ScriptEngine {
    */
   virtual size_t getHeapSize() { return 0; }
 
+  /**
+   * Get detailed heap statistics,
+   * the default implementation only fills usedHeapSize and totalHeapSize with getHeapSize().
+   */
+  virtual HeapStatistics getHeapStatistics();
+
   /**
    * An associated memory is native memory associated with script object.
    * This method is just an suggest to the engine,
@@ -235,6 +313,19 @@ class ScriptEngine {
   template <typename T = void>
   std::shared_ptr<T> getData();
 
+  /**
+   * @return the String of key in this engine, created at first call and cached until engine
+   * destroy.
+   */
+  Local<String> getInternedKey(const internal::InternedKey& key);
+
+  /**
+   * same as above, for key known only at runtime (ie. C++ string passed to Local<Object>::get).
+   * only short keys are cached, from the second time they are used, up to a fixed count per
+   * engine with least recently used ones evicted. others are created as a new String each call.
+   */
+  Local<String> getInternedKey(std::string_view key);
+
  protected:
   /**
    * should not be public, use destroy instead of dtor.
@@ -324,8 +324,10 @@ ClassDefineBuilder<T> defineClass(std::string name);
  * so "int" differs "std::string", because "script::Number" differs "script::String".
  * but "int" is same as "double", because they both represented as "script::Number".
  *
- * The implements try to convert Argument to func1 argument,
- * if convert success call fun1, otherwise continue on func2, etc...
+ * The implements check arguments count and script type (see Local<Value>::getKind) of each
+ * argument against func1 signature, if match call fun1, otherwise continue on func2, etc...
+ * The checks are pre-computed and don't throw, only a candidate passing the check but still
+ * rejected by its converter (ie. custom converter or ScriptClass of other type) costs an exception.
  * If no suitable func is found, an Exception is thrown with message "no valid overloaded function
  * chosen".
  *
@@ -425,10 +427,16 @@ class StaticDefine {
     std::string name;
     FunctionCallback callback;
     std::string traceName = name;
+    // set by ClassDefineBuilder::function<Func>(), called directly instead of through callback
+    Local<Value> (*directCallback)(const Arguments& args) = nullptr;
 
     FunctionDefine(std::string name, FunctionCallback callback, std::string traceName)
         : name(std::move(name)), callback(std::move(callback)), traceName(std::move(traceName)) {}
 
+    Local<Value> call(const Arguments& args) const {
+      return directCallback ? directCallback(args) : callback(args);
+    }
+
     SCRIPTX_CLASS_DEFINE_FRIENDS
     friend class ClassDefineState;
   };
@@ -476,10 +484,16 @@ class InstanceDefine {
     std::string name;
     FunctionCallback callback;
     std::string traceName = name;
+    // set by ClassDefineBuilder::instanceFunction<Func>(), called directly instead of callback
+    Local<Value> (*directCallback)(void* thiz, const Arguments& args) = nullptr;
 
     FunctionDefine(std::string name, FunctionCallback callback, std::string traceName)
         : name(std::move(name)), callback(std::move(callback)), traceName(std::move(traceName)) {}
 
+    Local<Value> call(void* thiz, const Arguments& args) const {
+      return directCallback ? directCallback(thiz, args) : callback(thiz, args);
+    }
+
     SCRIPTX_CLASS_DEFINE_FRIENDS
     friend class ClassDefineState;
   };
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <array>
 #include <cassert>
 #include <cstdint>
 #include <optional>
@@ -151,6 +152,112 @@ inline Local<Value> handleException(const Exception& e, bool nothrow) {
 
 class OverloadInvalidArguments : public std::exception {};
 
+/**
+ * Pre-computed shape of one overload candidate, checked before calling it,
+ * so that mismatched candidates are skipped without throwing OverloadInvalidArguments.
+ *
+ * The check is conservative: it only rejects arguments the converter would refuse for sure,
+ * a candidate passing it may still throw OverloadInvalidArguments (ie. custom converter, or native
+ * instance of another class), in which case the next candidate is tried as before.
+ */
+struct OverloadSignature {
+  static constexpr uint32_t kAnyKind = ~uint32_t(0);
+
+  static constexpr uint32_t kindBit(ValueKind kind) {
+    return uint32_t(1) << static_cast<int>(kind);
+  }
+
+  // raw FunctionCallback like, takes any arguments
+  bool acceptAny = true;
+  size_t argsCount = 0;
+  // bit mask of acceptable ValueKind, per argument
+  const uint32_t* kindMasks = nullptr;
+};
+
+// lazily computed ValueKind of arguments, shared by all candidates of one call
+class ArgumentKinds {
+  static constexpr size_t kCachedKinds = 8;
+
+  const Arguments& args_;
+  uint32_t computed_ = 0;
+  std::array<ValueKind, kCachedKinds> kinds_{};
+
+ public:
+  explicit ArgumentKinds(const Arguments& args) : args_(args) {}
+
+  ValueKind operator[](size_t i) {
+    if (i >= kCachedKinds) return args_[i].getKind();
+    if (!(computed_ & (uint32_t(1) << i))) {
+      kinds_[i] = args_[i].getKind();
+      computed_ |= uint32_t(1) << i;
+    }
+    return kinds_[i];
+  }
+
+  bool match(const OverloadSignature& signature) {
+    if (signature.acceptAny) return true;
+    if (signature.argsCount != args_.size()) return false;
+    for (size_t i = 0; i < signature.argsCount; ++i) {
+      auto mask = signature.kindMasks[i];
+      if (mask != OverloadSignature::kAnyKind && !(mask & OverloadSignature::kindBit((*this)[i]))) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+template <typename T>
+constexpr uint32_t argumentKindMask() {
+  using Type = typename ConverterDecay<T>::type;
+  constexpr auto bit = [](ValueKind kind) { return OverloadSignature::kindBit(kind); };
+  if constexpr (std::is_same_v<Type, bool> || std::is_same_v<Type, Local<Boolean>>) {
+    return bit(ValueKind::kBoolean);
+  } else if constexpr (std::is_arithmetic_v<Type> || std::is_same_v<Type, Local<Number>>) {
+    return bit(ValueKind::kNumber);
+  } else if constexpr (StringLikeConceptCondition(Type) || std::is_same_v<Type, Local<String>>) {
+    return bit(ValueKind::kString);
+  } else if constexpr (std::is_same_v<Type, Local<Function>>) {
+    return bit(ValueKind::kFunction);
+  } else if constexpr (std::is_same_v<Type, Local<Array>>) {
+    // Lua tables report kObject, let the converter decide
+    return bit(ValueKind::kArray) | bit(ValueKind::kObject);
+  } else if constexpr (std::is_same_v<Type, Local<ByteBuffer>>) {
+    return bit(ValueKind::kByteBuffer);
+  } else {
+    // Local<Value>, Local<Object>, ScriptClass and custom converters decide by themselves
+    return OverloadSignature::kAnyKind;
+  }
+}
+
+template <typename Args>
+struct OverloadSignatureHelper;
+
+template <typename... Args>
+struct OverloadSignatureHelper<std::tuple<Args...>> {
+  static constexpr std::array<uint32_t, sizeof...(Args)> kindMasks{argumentKindMask<Args>()...};
+
+  static OverloadSignature get() {
+    if constexpr (sizeof...(Args) == 1 &&
+                  std::conjunction_v<std::is_same<std::decay_t<Args>, Arguments>...>) {
+      return {};
+    } else {
+      return {false, sizeof...(Args), kindMasks.data()};
+    }
+  }
+};
+
+template <typename Func>
+OverloadSignature staticFuncSignature() {
+  return OverloadSignatureHelper<typename FuncTrait<Func>::Arguments>::get();
+}
+
+template <typename Func>
+OverloadSignature instanceFuncSignature() {
+  // skip the Class* argument
+  return OverloadSignatureHelper<typename ArgsTrait<Func>::Tail>::get();
+}
+
 template <typename>
 struct ConvertingFuncCallHelper {};
 
@@ -266,6 +373,83 @@ struct ConvertingFuncCallHelper<std::pair<Ret, std::tuple<Args...>>> {
   }
 };
 
+/**
+ * Binding of a function known at compile time (template parameter Func),
+ * its call is a plain function pointer without any functor state.
+ *
+ * Unlike ConvertingFuncCallHelper, no TypeHolder/argument tuple is staged,
+ * each argument is converted right inside the call expression,
+ * so temporaries like StringHolder live until Func returns.
+ */
+template <auto Func, bool Nothrow>
+struct DirectCallHelper {
+ private:
+  template <typename T>
+  static decltype(auto) source(const Local<Value>& arg) {
+    if constexpr (StringLikeConceptCondition(T)) {
+      return arg.asString().toStringHolder();
+    } else {
+      return arg;
+    }
+  }
+
+  template <typename... Converted>
+  static decltype(auto) invoke(bool& converted, Converted&&... args) {
+    converted = true;
+    return std::invoke(Func, std::forward<Converted>(args)...);
+  }
+
+  template <typename... Args, typename... Ins, size_t... index>
+  static Local<Value> call(const Arguments& args, std::index_sequence<index...>, Ins*... ins) {
+    bool converted = false;
+    try {
+      if (ConvertCallHelperUtils::checkArgs(args, sizeof...(Args), Nothrow)) {
+        return {};
+      }
+      using Ret = typename FuncTrait<decltype(Func)>::ReturnType;
+      if constexpr (std::is_same_v<Ret, void>) {
+        invoke(converted, ins..., TypeConverter<Args>::toCpp(source<Args>(args[index]))...);
+        return {};
+      } else {
+        return ConvertCallHelperUtils::convertAndReturn(
+            invoke(converted, ins..., TypeConverter<Args>::toCpp(source<Args>(args[index]))...),
+            Nothrow);
+      }
+    } catch (const Exception& e) {
+      // thrown by Func itself, not ours to handle
+      if (converted) throw;
+      return handleException(e, Nothrow);
+    }
+  }
+
+  template <typename ArgsTuple>
+  struct Unpack;
+
+  template <typename... Args>
+  struct Unpack<std::tuple<Args...>> {
+    static Local<Value> callStatic(const Arguments& args) {
+      return call<Args...>(args, std::index_sequence_for<Args...>());
+    }
+
+    template <typename Class>
+    static Local<Value> callInstance(void* thiz, const Arguments& args) {
+      return call<Args...>(args, std::index_sequence_for<Args...>(), static_cast<Class*>(thiz));
+    }
+  };
+
+ public:
+  static Local<Value> callStatic(const Arguments& args) {
+    return Unpack<typename FuncTrait<decltype(Func)>::Arguments>::callStatic(args);
+  }
+
+  template <typename Class>
+  static Local<Value> callInstance(/* Class* */ void* thiz, const Arguments& args) {
+    // skip the Class* argument
+    return Unpack<typename ArgsTrait<decltype(Func)>::Tail>::template callInstance<Class>(thiz,
+                                                                                        args);
+  }
+};
+
 template <typename T, typename = void>
 struct ClassConstructorHelper : std::false_type {};
 
@@ -322,18 +506,19 @@ inline FunctionCallback bindStaticFunc(const FunctionCallback& func, bool, bool
 
 template <typename... Func>
 FunctionCallback adaptOverLoadedFunction(Func&&... functions) {
+  std::array<OverloadSignature, sizeof...(Func)> signatures{staticFuncSignature<Func>()...};
   std::vector funcs{bindStaticFunc(std::forward<Func>(functions), false, true)...};
-  return [overload = std::move(funcs)](const Arguments& args) -> Local<Value> {
+  return [overload = std::move(funcs), signatures](const Arguments& args) -> Local<Value> {
+    ArgumentKinds kinds(args);
     for (size_t i = 0; i < sizeof...(Func); ++i) {
+      if (!kinds.match(signatures[i])) continue;
       try {
         return std::invoke(overload[i], args);
       } catch (const OverloadInvalidArguments&) {
-        if (i == sizeof...(Func) - 1) {
-          throw Exception("no valid overloaded function chosen");
-        }
+        // passed the kind check, but rejected by converter, try next one
       }
     }
-    return {};
+    throw Exception("no valid overloaded function chosen");
   };
 }
 
@@ -443,19 +628,20 @@ InstanceFunctionCallback bindInstanceFunc(const InstanceFunctionCallback& func,
 
 template <typename Class, typename... Func>
 InstanceFunctionCallback adaptOverloadedInstanceFunction(Func&&... functions) {
+  std::array<OverloadSignature, sizeof...(Func)> signatures{instanceFuncSignature<Func>()...};
   std::vector funcs{bindInstanceFunc<Class>(std::forward<Func>(functions), false, true)...};
-  return [overload = std::move(funcs)](/* Class* */ void* thiz,
-                                       const Arguments& args) -> Local<Value> {
+  return [overload = std::move(funcs), signatures](/* Class* */ void* thiz,
+                                                   const Arguments& args) -> Local<Value> {
+    ArgumentKinds kinds(args);
     for (size_t i = 0; i < sizeof...(Func); ++i) {
+      if (!kinds.match(signatures[i])) continue;
       try {
         return std::invoke(overload[i], static_cast<Class*>(thiz), args);
       } catch (const OverloadInvalidArguments&) {
-        if (i == sizeof...(Func) - 1) {
-          throw Exception("no valid overloaded function chosen");
-        }
+        // passed the kind check, but rejected by converter, try next one
       }
     }
-    return {};
+    throw Exception("no valid overloaded function chosen");
   };
 }
 
@@ -629,7 +815,7 @@ template <typename StringLike, typename T, typename>
 inline internal::type_t<void, decltype(&internal::TypeConverter<T>::toScript)> Local<Object>::set(
     StringLike&& keyStringLike, T&& value) const {
   auto val = internal::TypeConverter<T>::toScript(std::forward<T>(value));
-  set(String::newString(std::forward<StringLike>(keyStringLike)),
+  set(internal::makePropertyKey(std::forward<StringLike>(keyStringLike)),
       static_cast<const Local<Value>&>(val));
 }
 
@@ -728,7 +914,7 @@ template <typename StringLike, typename T, typename>
 inline internal::type_t<void, decltype(&internal::TypeConverter<T>::toScript)> ScriptEngine::set(
     StringLike&& keyStringLike, T&& value) {
   auto val = internal::TypeConverter<T>::toScript(std::forward<T>(value));
-  set(String::newString(std::forward<StringLike>(keyStringLike)),
+  set(internal::makePropertyKey(std::forward<StringLike>(keyStringLike)),
       static_cast<const Local<Value>&>(val));
 }
 
@@ -804,6 +990,27 @@ class InstanceDefineBuilder : public InstanceDefineBuilderState {
     return thiz();
   }
 
+  /**
+   * bind a member function (or function taking T* as the first argument) known at compile time.
+   * The callback is a plain function pointer, and arguments are converted directly into the call.
+   *
+   * \code
+   * defineClass<Foo>("Foo").instanceFunction<&Foo::bar>("bar");
+   * \endcode
+   */
+  template <auto Func, bool nothrow = kBindingNoThrowDefaultValue>
+  ClassDefineBuilder<T>& instanceFunction(std::string name) {
+    static_assert(
+        std::is_convertible_v<T*, typename ArgsTrait<decltype(Func)>::template Arg<0>>);
+    Local<Value> (*callback)(void*, const Arguments&) =
+        &DirectCallHelper<Func, nothrow>::template callInstance<T>;
+    // callback is kept for introspection, backends call directCallback
+    auto& define = insFunctions_.emplace_back(
+        typename InstanceDefine::FunctionDefine{std::move(name), callback, {}});
+    define.directCallback = callback;
+    return thiz();
+  }
+
   template <typename G, typename S = InstanceSetterCallback>
   sfina<decltype(internal::bindInstanceGet<T>(std::declval<G>(), false)),
         decltype(internal::bindInstanceSet<T>(std::declval<S>(), false))>
@@ -949,6 +1156,25 @@ class ClassDefineBuilder : public internal::InstanceDefineBuilder<T> {
     return *this;
   }
 
+  /**
+   * bind a static function known at compile time.
+   * The callback is a plain function pointer, and arguments are converted directly into the call.
+   *
+   * \code
+   * defineClass<void>("Math").function<&add>("add");
+   * \endcode
+   */
+  template <auto Func, bool nothrow = internal::kBindingNoThrowDefaultValue>
+  ClassDefineBuilder<T>& function(std::string name) {
+    Local<Value> (*callback)(const Arguments&) =
+        &internal::DirectCallHelper<Func, nothrow>::callStatic;
+    // callback is kept for introspection, backends call directCallback
+    auto& define = functions_.emplace_back(
+        internal::StaticDefine::FunctionDefine{std::move(name), callback, {}});
+    define.directCallback = callback;
+    return *this;
+  }
+
   template <typename G, typename S = SetterCallback>
   sfina<decltype(internal::bindStaticGet(std::declval<G>(), false)),
         decltype(internal::bindStaticSet(std::declval<S>(), false))>
@@ -16,8 +16,15 @@
  */
 
 #pragma once
+#include <array>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <map>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
 #include "Reference.h"
 #include "Scope.h"
 #include "Utils.h"
@@ -44,6 +51,11 @@ namespace script::converter {
  *
  * 7. any pointer of subclass of ScriptClass
  *
+ * 8. std::vector std::array -> Array, std::map std::unordered_map (with string key) -> Object,
+ *    std::optional -> value or null, of any supported type above (except non-owning strings)
+ *
+ * 9. plain struct described by StructFields -> Object
+ *
  * see docs and UnitTests for more detail
  *
  */
@@ -273,4 +285,325 @@ constexpr bool isConvertible = internal::IsConvertibleHelper<T>::value;
 
 }  // namespace converter
 
-}  // namespace script
\ No newline at end of file
+}  // namespace script
+
+namespace script::internal {
+
+// element of container must own its data, string_view and char* would dangle
+template <typename T>
+constexpr bool isContainerElement =
+    ::script::converter::isConvertible<T> && !std::is_same_v<T, std::string_view> &&
+    !std::is_same_v<T, const char*>
+#ifdef __cpp_lib_char8_t
+    && !std::is_same_v<T, std::u8string_view> && !std::is_same_v<T, const char8_t*>
+#endif
+    ;
+
+template <typename T>
+constexpr bool isContainerKey = std::is_same_v<T, std::string>
+#ifdef __cpp_lib_char8_t
+                                || std::is_same_v<T, std::u8string>
+#endif
+    ;
+
+// ByteBuffer element type for typed-array fast path, kUnspecified for none.
+template <typename T>
+constexpr ByteBuffer::Type typedArrayType() {
+  if constexpr (std::is_same_v<T, float>) {
+    return ByteBuffer::Type::kFloat32;
+  } else if constexpr (std::is_same_v<T, double>) {
+    return ByteBuffer::Type::kFloat64;
+  } else if constexpr (std::is_same_v<T, int32_t>) {
+    return ByteBuffer::Type::kInt32;
+  } else {
+    return ByteBuffer::Type::kUnspecified;
+  }
+}
+
+/**
+ * convert elements of a sequence to Array, with a single newArray call
+ */
+template <typename T, typename Iterable>
+Local<Value> sequenceToScript(const Iterable& value) {
+  std::vector<Local<Value>> elements;
+  elements.reserve(std::size(value));
+  for (auto&& e : value) {
+    elements.push_back(TypeConverter<T>::toScript(e));
+  }
+  return Array::newArray(elements);
+}
+
+/**
+ * @param resize called with element count, returns pointer to elements
+ */
+template <typename T, typename Resize>
+void sequenceToCpp(const Local<Value>& value, Resize&& resize) {
+  if constexpr (typedArrayType<T>() != ByteBuffer::Type::kUnspecified) {
+    if (value.isByteBuffer()) {
+      auto buffer = value.asByteBuffer();
+      if (buffer.getType() != typedArrayType<T>()) {
+        throw Exception("ByteBuffer element type mismatch");
+      }
+      buffer.sync();
+      auto count = buffer.byteLength() / sizeof(T);
+      auto data = resize(count);
+      if (count > 0) std::memcpy(data, buffer.getRawBytes(), count * sizeof(T));
+      return;
+    }
+  }
+
+  auto array = value.asArray();
+  auto count = array.size();
+  auto data = resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    data[i] = TypeConverter<T>::toCpp(array.get(i));
+  }
+}
+
+template <typename Map>
+Local<Value> mapToScript(const Map& value) {
+  auto object = Object::newObject();
+  for (auto&& [k, v] : value) {
+    object.set(String::newString(k), TypeConverter<typename Map::mapped_type>::toScript(v));
+  }
+  return object;
+}
+
+template <typename Map>
+Map mapToCpp(const Local<Value>& value) {
+  using Key = typename Map::key_type;
+  auto object = value.asObject();
+  Map map;
+  for (auto& key : object.getKeys()) {
+    auto holder = key.toStringHolder();
+    Key cppKey;
+    if constexpr (std::is_same_v<Key, std::string>) {
+      cppKey = holder.string();
+    }
+#ifdef __cpp_lib_char8_t
+    else {
+      cppKey = holder.u8string();
+    }
+#endif
+    map.emplace(std::move(cppKey),
+                TypeConverter<typename Map::mapped_type>::toCpp(object.get(key)));
+  }
+  return map;
+}
+
+}  // namespace script::internal
+
+namespace script::converter {
+
+/**
+ * Array <-> std::vector, also accepts typed array (ByteBuffer of same element type)
+ * for std::vector<float|double|int32_t>.
+ */
+template <typename T, typename Alloc>
+struct Converter<std::vector<T, Alloc>, std::enable_if_t<internal::isContainerElement<T>>> {
+  static Local<Value> toScript(const std::vector<T, Alloc>& value) {
+    return internal::sequenceToScript<T>(value);
+  }
+
+  static std::vector<T, Alloc> toCpp(const Local<Value>& value) {
+    std::vector<T, Alloc> ret;
+    if constexpr (std::is_same_v<T, bool>) {
+      // vector<bool> has no data()
+      auto array = value.asArray();
+      auto count = array.size();
+      ret.reserve(count);
+      for (size_t i = 0; i < count; ++i) {
+        ret.push_back(internal::TypeConverter<bool>::toCpp(array.get(i)));
+      }
+    } else {
+      internal::sequenceToCpp<T>(value, [&ret](size_t count) {
+        ret.resize(count);
+        return ret.data();
+      });
+    }
+    return ret;
+  }
+};
+
+/**
+ * Array <-> std::array, throws if length differs
+ */
+template <typename T, size_t N>
+struct Converter<std::array<T, N>, std::enable_if_t<internal::isContainerElement<T>>> {
+  static Local<Value> toScript(const std::array<T, N>& value) {
+    return internal::sequenceToScript<T>(value);
+  }
+
+  static std::array<T, N> toCpp(const Local<Value>& value) {
+    std::array<T, N> ret{};
+    internal::sequenceToCpp<T>(value, [&ret](size_t count) {
+      if (count != N) {
+        throw Exception("Array length mismatch, expect:" + std::to_string(N) +
+                        " got:" + std::to_string(count));
+      }
+      return ret.data();
+    });
+    return ret;
+  }
+};
+
+/**
+ * Object <-> std::map
+ */
+template <typename K, typename V, typename Compare, typename Alloc>
+struct Converter<std::map<K, V, Compare, Alloc>,
+                 std::enable_if_t<internal::isContainerKey<K> && internal::isContainerElement<V>>> {
+  static Local<Value> toScript(const std::map<K, V, Compare, Alloc>& value) {
+    return internal::mapToScript(value);
+  }
+
+  static std::map<K, V, Compare, Alloc> toCpp(const Local<Value>& value) {
+    return internal::mapToCpp<std::map<K, V, Compare, Alloc>>(value);
+  }
+};
+
+/**
+ * Object <-> std::unordered_map
+ */
+template <typename K, typename V, typename Hash, typename Equal, typename Alloc>
+struct Converter<std::unordered_map<K, V, Hash, Equal, Alloc>,
+                 std::enable_if_t<internal::isContainerKey<K> && internal::isContainerElement<V>>> {
+  static Local<Value> toScript(const std::unordered_map<K, V, Hash, Equal, Alloc>& value) {
+    return internal::mapToScript(value);
+  }
+
+  static std::unordered_map<K, V, Hash, Equal, Alloc> toCpp(const Local<Value>& value) {
+    return internal::mapToCpp<std::unordered_map<K, V, Hash, Equal, Alloc>>(value);
+  }
+};
+
+/**
+ * null <-> std::nullopt
+ */
+template <typename T>
+struct Converter<std::optional<T>, std::enable_if_t<internal::isContainerElement<T>>> {
+  static Local<Value> toScript(const std::optional<T>& value) {
+    if (!value) return {};
+    return internal::TypeConverter<T>::toScript(*value);
+  }
+
+  static std::optional<T> toCpp(const Local<Value>& value) {
+    if (value.isNull()) return std::nullopt;
+    return internal::TypeConverter<T>::toCpp(value);
+  }
+};
+
+}  // namespace script::converter
+
+namespace script::converter {
+
+template <typename Class, typename Member>
+struct StructField {
+  const char* name;
+  Member Class::*member;
+};
+
+template <typename Class, typename Member>
+constexpr StructField<Class, Member> field(const char* name, Member Class::*member) {
+  return {name, member};
+}
+
+/**
+ * specialize this template to convert a plain struct T to/from Object, field by field.
+ *
+ * \code
+ * struct Point {
+ *   double x;
+ *   double y;
+ * };
+ *
+ * namespace script::converter {
+ * template <>
+ * struct StructFields<Point> {
+ *   static constexpr auto fields =
+ *       std::make_tuple(SCRIPTX_STRUCT_FIELD(Point, x), SCRIPTX_STRUCT_FIELD(Point, y));
+ * };
+ * }
+ * \endcode
+ *
+ * field names are interned per engine, see ScriptEngine::getInternedKey.
+ * T must be default constructible, and every field type must be convertible.
+ */
+template <typename T>
+struct StructFields;
+
+#define SCRIPTX_STRUCT_FIELD(Class, member) ::script::converter::field(#member, &Class::member)
+
+}  // namespace script::converter
+
+namespace script::internal {
+
+template <typename T, typename = void>
+struct HasStructFields : std::false_type {};
+
+template <typename T>
+struct HasStructFields<T, std::void_t<decltype(::script::converter::StructFields<T>::fields)>>
+    : std::true_type {};
+
+template <typename T>
+class StructConverter {
+  static constexpr auto& fields() { return ::script::converter::StructFields<T>::fields; }
+
+  static constexpr size_t kFieldCount =
+      std::tuple_size_v<std::decay_t<decltype(::script::converter::StructFields<T>::fields)>>;
+
+  template <size_t... index>
+  static const std::array<InternedKey, kFieldCount>& keys(std::index_sequence<index...>) {
+    static const std::array<InternedKey, kFieldCount> keys{
+        InternedKey(std::get<index>(fields()).name)...};
+    return keys;
+  }
+
+  static const std::array<InternedKey, kFieldCount>& keys() {
+    return keys(std::make_index_sequence<kFieldCount>());
+  }
+
+  template <size_t... index>
+  static void set(ScriptEngine* engine, const Local<Object>& object, const T& value,
+                  std::index_sequence<index...>) {
+    auto& k = keys();
+    (object.set(engine->getInternedKey(k[index]),
+                TypeConverter<std::decay_t<decltype(value.*(std::get<index>(fields()).member))>>::
+                    toScript(value.*(std::get<index>(fields()).member))),
+     ...);
+  }
+
+  template <size_t... index>
+  static void get(ScriptEngine* engine, const Local<Object>& object, T& value,
+                  std::index_sequence<index...>) {
+    auto& k = keys();
+    ((value.*(std::get<index>(fields()).member) =
+          TypeConverter<std::decay_t<decltype(value.*(std::get<index>(fields()).member))>>::toCpp(
+              object.get(engine->getInternedKey(k[index])))),
+     ...);
+  }
+
+ public:
+  static Local<Value> toScript(const T& value) {
+    auto object = Object::newObject();
+    set(EngineScope::currentEngine(), object, value, std::make_index_sequence<kFieldCount>());
+    return object;
+  }
+
+  static T toCpp(const Local<Value>& value) {
+    auto object = value.asObject();
+    T ret{};
+    get(EngineScope::currentEngine(), object, ret, std::make_index_sequence<kFieldCount>());
+    return ret;
+  }
+};
+
+}  // namespace script::internal
+
+namespace script::converter {
+
+template <typename T>
+struct Converter<T, std::enable_if_t<internal::HasStructFields<T>::value>>
+    : internal::StructConverter<T> {};
+
+}  // namespace script::converter
@@ -16,6 +16,7 @@
  */
 
 #include <ScriptX/ScriptX.h>
+#include <cstring>
 
 namespace script {
 
@@ -32,6 +33,45 @@ std::string Local<String>::toString() const { return toStringHolder().string();
 std::u8string Local<String>::toU8string() const { return toStringHolder().u8string(); }
 #endif
 
+void* Local<ByteBuffer>::checkedElements(ByteBuffer::Type type, size_t elementSize,
+                                         size_t alignment, size_t& count) const {
+  auto bufferType = getType();
+  auto length = byteLength();
+  auto data = getRawBytes();
+
+  if (bufferType != type && elementSize != 1) {
+    if (bufferType != ByteBuffer::Type::kUnspecified) {
+      throw Exception("ByteBuffer element type mismatch");
+    }
+    if (length % elementSize != 0 || reinterpret_cast<uintptr_t>(data) % alignment != 0) {
+      throw Exception("ByteBuffer length or address is not aligned with element type");
+    }
+  }
+
+  count = length / elementSize;
+  return data;
+}
+
+void Local<ByteBuffer>::copyFrom(const void* data, size_t byteLength, size_t byteOffset) const {
+  auto length = this->byteLength();
+  if (byteOffset > length || byteLength > length - byteOffset) {
+    throw Exception("ByteBuffer copyFrom out of range");
+  }
+  if (byteLength == 0) return;
+  std::memcpy(static_cast<uint8_t*>(getRawBytes()) + byteOffset, data, byteLength);
+  commit();
+}
+
+void Local<ByteBuffer>::copyTo(void* data, size_t byteLength, size_t byteOffset) const {
+  auto length = this->byteLength();
+  if (byteOffset > length || byteLength > length - byteOffset) {
+    throw Exception("ByteBuffer copyTo out of range");
+  }
+  if (byteLength == 0) return;
+  sync();
+  std::memcpy(data, static_cast<const uint8_t*>(getRawBytes()) + byteOffset, byteLength);
+}
+
 std::vector<std::string> Local<Object>::getKeyNames() const {
   std::vector<std::string> ret;
   script::StackFrameScope stack;
@@ -18,6 +18,8 @@
 #pragma once
 
 #include <initializer_list>
+#include <span>
+#include <string_view>
 #include <vector>
 #include "Value.h"
 #include "foundation.h"
@@ -218,6 +220,19 @@ void swap(Weak<T>& lhs, Weak<T>& rhs) {
 template <>
 class Local<String>;
 
+namespace internal {
+
+/**
+ * String for property key, short keys are interned in current engine.
+ * see ScriptEngine::getInternedKey(std::string_view)
+ */
+Local<String> makePropertyKey(std::string_view key);
+
+template <typename StringLike>
+Local<String> makePropertyKey(StringLike&& keyStringLike);
+
+}  // namespace internal
+
 #define SPECIALIZE_LOCAL(ValueType)                                               \
  public:                                                                          \
   Local(const Local<ValueType>& copy);                                            \
@@ -335,7 +350,7 @@ class Local<Object> {
 
   template <typename StringLike, StringLikeConcept(StringLike)>
   Local<Value> get(StringLike&& keyStringLike) const {
-    return get(String::newString(std::forward<StringLike>(keyStringLike)));
+    return get(internal::makePropertyKey(std::forward<StringLike>(keyStringLike)));
   }
 
   void set(const Local<String>& key, const Local<Value>& value) const;
@@ -357,14 +372,14 @@ class Local<Object> {
 
   template <typename StringLike, StringLikeConcept(StringLike)>
   void remove(StringLike&& keyStringLike) const {
-    remove(String::newString(std::forward<StringLike>(keyStringLike)));
+    remove(internal::makePropertyKey(std::forward<StringLike>(keyStringLike)));
   }
 
   bool has(const Local<String>& key) const;
 
   template <typename StringLike, StringLikeConcept(StringLike)>
   bool has(StringLike&& keyStringLike) const {
-    return has(String::newString(std::forward<StringLike>(keyStringLike)));
+    return has(internal::makePropertyKey(std::forward<StringLike>(keyStringLike)));
   }
 
   /**
@@ -417,6 +432,15 @@ class Local<String> {
   friend class StringHolder;
 };
 
+template <typename StringLike>
+Local<String> internal::makePropertyKey(StringLike&& keyStringLike) {
+  if constexpr (std::is_convertible_v<StringLike, std::string_view>) {
+    return makePropertyKey(std::string_view(keyStringLike));
+  } else {
+    return String::newString(std::forward<StringLike>(keyStringLike));
+  }
+}
+
 template <>
 class Local<Number> {
   SPECIALIZE_LOCAL(Number)
@@ -626,7 +650,48 @@ class Local<ByteBuffer> {
    */
   void sync() const;
 
+  /**
+   * typed view of the buffer, type and size are checked once here.
+   *
+   * T should match getType(), or the buffer is kUnspecified (ie. ArrayBuffer, DataView)
+   * with byteLength and address fit for T. Byte types (int8_t, uint8_t) view any buffer.
+   * On mismatch an Exception is thrown.
+   *
+   * The span is only valid during the Local<ByteBuffer> lifecycle.
+   * For non-shared ByteBuffer, call sync() before reading and commit() after writing.
+   *
+   * \code
+   * for (auto& sample : buffer.asSpan<float>()) {
+   *   sample *= gain;
+   * }
+   * \endcode
+   */
+  template <typename T>
+  std::span<T> asSpan() const {
+    static_assert(ByteBuffer::getTypeOf<T>() != ByteBuffer::Type::kUnspecified,
+                  "T must be a typed array element type");
+    size_t count;
+    auto data = checkedElements(ByteBuffer::getTypeOf<T>(), sizeof(T), alignof(T), count);
+    return {static_cast<T*>(data), count};
+  }
+
+  /**
+   * copy byteLength bytes from data into this buffer at byteOffset, then commit().
+   * throws Exception if out of range.
+   */
+  void copyFrom(const void* data, size_t byteLength, size_t byteOffset = 0) const;
+
+  /**
+   * sync(), then copy byteLength bytes at byteOffset of this buffer into data.
+   * throws Exception if out of range.
+   */
+  void copyTo(void* data, size_t byteLength, size_t byteOffset = 0) const;
+
   SPECIALIZE_NON_VALUE(ByteBuffer);
+
+ private:
+  void* checkedElements(ByteBuffer::Type type, size_t elementSize, size_t alignment,
+                        size_t& count) const;
 };
 
 template <>
@@ -21,6 +21,7 @@
 #include <ostream>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include "foundation.h"
 #include SCRIPTX_BACKEND(Engine.h)
 
@@ -293,6 +294,37 @@ class ByteBuffer : public Value {
     return static_cast<uint8_t>(static_cast<uint16_t>(type) & 0xFFu);  // NOLINT
   }
 
+  /**
+   * @return the Type of C++ element type T, kUnspecified if T is not a typed array element.
+   */
+  template <typename T>
+  static constexpr Type getTypeOf() {
+    using E = std::remove_cv_t<T>;
+    if constexpr (std::is_same_v<E, int8_t>) {
+      return Type::kInt8;
+    } else if constexpr (std::is_same_v<E, uint8_t>) {
+      return Type::kUint8;
+    } else if constexpr (std::is_same_v<E, int16_t>) {
+      return Type::kInt16;
+    } else if constexpr (std::is_same_v<E, uint16_t>) {
+      return Type::kUint16;
+    } else if constexpr (std::is_same_v<E, int32_t>) {
+      return Type::kInt32;
+    } else if constexpr (std::is_same_v<E, uint32_t>) {
+      return Type::kUint32;
+    } else if constexpr (std::is_same_v<E, int64_t>) {
+      return Type::kInt64;
+    } else if constexpr (std::is_same_v<E, uint64_t>) {
+      return Type::kUint64;
+    } else if constexpr (std::is_same_v<E, float>) {
+      return Type::kFloat32;
+    } else if constexpr (std::is_same_v<E, double>) {
+      return Type::kFloat64;
+    } else {
+      return Type::kUnspecified;
+    }
+  }
+
   /**
    * create a new ByteBuffer with given size.
    * on failure, an Exception is thrown.
@@ -319,6 +351,17 @@ class ByteBuffer : public Value {
    * note: the returned Local<ByteBuffer> use nativeBuffer as backing store,
    * thus ret.getRawBytes() == nativeBuffer.get()
    *
+   * This is the zero-copy path for large buffers (frames, textures, etc).
+   * To hand over memory that is not owned by a shared_ptr,
+   * pass the release callback as deleter:
+   *
+   * \code
+   * auto buffer = ByteBuffer::newByteBuffer(
+   *     std::shared_ptr<void>(frame->pixels, [frame](void*) { frame->release(); }), frame->size);
+   * \endcode
+   *
+   * the deleter is called once both native and script side drop the buffer,
+   * and may be called on engine destroy.
    */
   static Local<ByteBuffer> newByteBuffer(std::shared_ptr<void> nativeBuffer, size_t size);
 };
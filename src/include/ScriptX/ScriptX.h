@@ -38,6 +38,8 @@
 #endif
 
 // utils
+#include "../../utils/CodeCache.h"
+#include "../../utils/EnginePool.h"
 #include "../../utils/MessageQueue.h"
 #include "../../utils/ThreadPool.h"
 
@@ -0,0 +1,83 @@
+/*
+ * Tencent is pleased to support the open source community by making ScriptX available.
+ * Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace script::utils {
+
+/**
+ * Bookkeeping for ScriptEngine::adjustAssociatedMemory.
+ *
+ * Where the runtime has its own accounting hook (ie. jsi::Object::setExternalMemoryPressure),
+ * backends report native memory there and only record it here with adjustReported, so that
+ * the runtime schedules the GC. This counter is the fallback for memory that can't be
+ * reported that way: native memory reported since the last GC is accumulated, once it crosses
+ * gcThreshold the engine should run a GC, so that small script objects owning large native
+ * allocations are collected in time instead of piling up.
+ */
+class AssociatedMemoryCounter {
+ public:
+  static constexpr size_t kDefaultGcThreshold = 8 * 1024 * 1024;
+
+  /**
+   * @return true if a GC should be triggered.
+   */
+  bool adjust(int64_t count) {
+    total_ += count;
+    if (total_ < 0) total_ = 0;
+    if (count <= 0) return false;
+
+    sinceLastGc_ += static_cast<size_t>(count);
+    return gcThreshold_ != 0 && sinceLastGc_ >= gcThreshold_;
+  }
+
+  /**
+   * record memory already reported to the runtime's own accounting,
+   * it's part of total() but never triggers a GC from here.
+   */
+  void adjustReported(int64_t count) {
+    reported_ += count;
+    if (reported_ < 0) reported_ = 0;
+  }
+
+  void onGc() { sinceLastGc_ = 0; }
+
+  size_t total() const { return static_cast<size_t>(total_ + reported_); }
+
+  /**
+   * @return the part of total() recorded by adjustReported.
+   */
+  size_t reported() const { return static_cast<size_t>(reported_); }
+
+  size_t gcThreshold() const { return gcThreshold_; }
+
+  /**
+   * @param threshold bytes of newly associated memory to trigger a GC, 0 to disable.
+   */
+  void setGcThreshold(size_t threshold) { gcThreshold_ = threshold; }
+
+ private:
+  int64_t total_ = 0;
+  int64_t reported_ = 0;
+  size_t sinceLastGc_ = 0;
+  size_t gcThreshold_ = kDefaultGcThreshold;
+};
+
+}  // namespace script::utils
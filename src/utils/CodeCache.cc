@@ -0,0 +1,106 @@
+/*
+ * Tencent is pleased to support the open source community by making ScriptX available.
+ * Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CodeCache.h"
+
+namespace script::utils {
+
+uint64_t CodeCacheStore::hash(std::string_view source, std::string_view sourceFile) {
+  constexpr uint64_t kOffsetBasis = 14695981039346656037ull;
+  constexpr uint64_t kPrime = 1099511628211ull;
+
+  uint64_t h = kOffsetBasis;
+  auto mix = [&h](std::string_view bytes) {
+    for (auto c : bytes) {
+      h ^= static_cast<uint8_t>(c);
+      h *= kPrime;
+    }
+    // length as separator, so that ("ab", "c") differs from ("a", "bc")
+    for (size_t len = bytes.size(), i = 0; i < sizeof(len); ++i, len >>= 8) {
+      h ^= static_cast<uint8_t>(len & 0xFFu);
+      h *= kPrime;
+    }
+  };
+
+  mix(source);
+  mix(sourceFile);
+  return h;
+}
+
+LruCodeCacheStore::LruCodeCacheStore(size_t maxBytes) : maxBytes_(maxBytes) {}
+
+CodeCacheStore::Data LruCodeCacheStore::get(uint64_t key) {
+  std::lock_guard<std::mutex> lock(lock_);
+  auto it = index_.find(key);
+  if (it == index_.end()) return nullptr;
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return it->second->second;
+}
+
+void LruCodeCacheStore::put(uint64_t key, Data data) {
+  if (!data) return;
+  auto size = data->size();
+
+  std::lock_guard<std::mutex> lock(lock_);
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    bytes_ -= it->second->second->size();
+    lru_.erase(it->second);
+    index_.erase(it);
+  }
+  if (size > maxBytes_) return;
+
+  evictUntil(maxBytes_ - size);
+  lru_.emplace_front(key, std::move(data));
+  index_.emplace(key, lru_.begin());
+  bytes_ += size;
+}
+
+void LruCodeCacheStore::remove(uint64_t key) {
+  std::lock_guard<std::mutex> lock(lock_);
+  auto it = index_.find(key);
+  if (it == index_.end()) return;
+  bytes_ -= it->second->second->size();
+  lru_.erase(it->second);
+  index_.erase(it);
+}
+
+void LruCodeCacheStore::clear() {
+  std::lock_guard<std::mutex> lock(lock_);
+  evictUntil(0);
+}
+
+size_t LruCodeCacheStore::size() {
+  std::lock_guard<std::mutex> lock(lock_);
+  return index_.size();
+}
+
+size_t LruCodeCacheStore::bytes() {
+  std::lock_guard<std::mutex> lock(lock_);
+  return bytes_;
+}
+
+void LruCodeCacheStore::evictUntil(size_t limit) {
+  while (bytes_ > limit && !lru_.empty()) {
+    auto& last = lru_.back();
+    bytes_ -= last.second->size();
+    index_.erase(last.first);
+    lru_.pop_back();
+  }
+}
+
+}  // namespace script::utils
@@ -0,0 +1,106 @@
+/*
+ * Tencent is pleased to support the open source community by making ScriptX available.
+ * Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "../foundation.h"
+
+namespace script::utils {
+
+/**
+ * Storage of compiled script (bytecode or engine specific code cache),
+ * used by engines to skip parsing sources they have seen before.
+ *
+ * One store can be shared by many engine instances, even on different threads,
+ * so implementations must be thread-safe.
+ *
+ * Entries are engine (and engine version) specific,
+ * a persistent implementation should partition its storage by ScriptEngine::getEngineVersion().
+ */
+class CodeCacheStore {
+ public:
+  using Data = std::shared_ptr<const std::vector<uint8_t>>;
+
+  virtual ~CodeCacheStore() = default;
+
+  /**
+   * @return cached data for key, or nullptr if not found.
+   */
+  virtual Data get(uint64_t key) = 0;
+
+  virtual void put(uint64_t key, Data data) = 0;
+
+  /**
+   * drop an entry, called by engine when the cached data is rejected.
+   */
+  virtual void remove(uint64_t key) = 0;
+
+  /**
+   * content hash used as cache key (64-bit FNV-1a), stable across processes.
+   * sourceFile is mixed in because compiled code carries it for stack trace.
+   */
+  static uint64_t hash(std::string_view source, std::string_view sourceFile = {});
+};
+
+/**
+ * In-memory CodeCacheStore with a total size limit and LRU eviction.
+ */
+class LruCodeCacheStore : public CodeCacheStore {
+ public:
+  /**
+   * @param maxBytes max total size of cached data, entry bigger than maxBytes is never stored.
+   */
+  explicit LruCodeCacheStore(size_t maxBytes = 32 * 1024 * 1024);
+
+  SCRIPTX_DISALLOW_COPY_AND_MOVE(LruCodeCacheStore);
+
+  Data get(uint64_t key) override;
+
+  void put(uint64_t key, Data data) override;
+
+  void remove(uint64_t key) override;
+
+  void clear();
+
+  size_t size();
+
+  size_t bytes();
+
+  size_t maxBytes() const { return maxBytes_; }
+
+ private:
+  using Entry = std::pair<uint64_t, Data>;
+
+  void evictUntil(size_t limit);
+
+  const size_t maxBytes_;
+  std::mutex lock_;
+  size_t bytes_ = 0;
+  // front is the most recently used
+  std::list<Entry> lru_;
+  std::unordered_map<uint64_t, std::list<Entry>::iterator> index_;
+};
+
+}  // namespace script::utils
@@ -0,0 +1,258 @@
+/*
+ * Tencent is pleased to support the open source community by making ScriptX available.
+ * Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "EnginePool.h"
+#include <ScriptX/ScriptX.h>
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+#include <utility>
+
+namespace script::utils {
+
+EnginePool::Lease::Lease(Lease&& other) noexcept
+    : pool_(std::exchange(other.pool_, nullptr)),
+      engine_(std::exchange(other.engine_, nullptr)),
+      recycle_(std::exchange(other.recycle_, false)) {}
+
+EnginePool::Lease& EnginePool::Lease::operator=(Lease&& other) noexcept {
+  if (this != &other) {
+    release();
+    pool_ = std::exchange(other.pool_, nullptr);
+    engine_ = std::exchange(other.engine_, nullptr);
+    recycle_ = std::exchange(other.recycle_, false);
+  }
+  return *this;
+}
+
+EnginePool::Lease::~Lease() { release(); }
+
+void EnginePool::Lease::release() {
+  if (pool_ && engine_) {
+    pool_->giveBack(engine_, recycle_);
+  }
+  pool_ = nullptr;
+  engine_ = nullptr;
+  recycle_ = false;
+}
+
+EnginePool::EnginePool(Config config) : config_(std::move(config)) {
+  if (!config_.engineFactory) {
+    throw std::runtime_error("EnginePool::Config::engineFactory is required");
+  }
+  prewarm();
+}
+
+EnginePool::~EnginePool() {
+  std::unique_ptr<ThreadPool> refillThread;
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    refillThread = std::move(refillThread_);
+  }
+  if (refillThread) {
+    // drop a pending refill and wait for a running one, which takes lock_
+    refillThread->shutdownNow(true);
+  }
+
+  std::lock_guard<std::mutex> lock(lock_);
+  // leases point to this pool
+  assert(leased_.empty());
+  for (auto& entry : idle_) {
+    destroyEngine(entry.engine);
+  }
+  idle_.clear();
+}
+
+EnginePool::Entry EnginePool::createEngine() {
+  auto engine = config_.engineFactory();
+  if (engine == nullptr) {
+    throw std::runtime_error("EnginePool::Config::engineFactory returned nullptr");
+  }
+  try {
+    EngineScope scope(engine);
+    for (auto& nativeClass : config_.nativeClasses) {
+      engine->registerNativeClass(nativeClass);
+    }
+    for (auto& script : config_.baseScripts) {
+      engine->eval(script);
+    }
+    if (config_.initializer) {
+      config_.initializer(engine);
+    }
+  } catch (...) {
+    destroyEngine(engine);
+    throw;
+  }
+
+  std::lock_guard<std::mutex> lock(lock_);
+  statistics_.created++;
+  return {engine, 0};
+}
+
+void EnginePool::destroyEngine(ScriptEngine* engine) { engine->destroy(); }
+
+void EnginePool::prewarm() {
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      if (idle_.size() >= config_.poolSize) return;
+    }
+    // initialize without holding the lock, other threads can still acquire
+    auto entry = createEngine();
+
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      if (idle_.size() < config_.poolSize) {
+        idle_.push_back(entry);
+        continue;
+      }
+    }
+    // filled meanwhile by another prewarm() or a returned lease
+    destroyEngine(entry.engine);
+    return;
+  }
+}
+
+EnginePool::Lease EnginePool::acquire() {
+  Entry entry;
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    if (!idle_.empty()) {
+      entry = idle_.front();
+      idle_.pop_front();
+    }
+  }
+  if (!entry.engine) {
+    entry = createEngine();
+  }
+
+  entry.leaseCount++;
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    leased_.push_back(entry);
+  }
+  return Lease(this, entry.engine);
+}
+
+// called from Lease's destructor, must not throw
+void EnginePool::giveBack(ScriptEngine* engine, bool recycle) {
+  Entry entry;
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    auto it = std::find_if(leased_.begin(), leased_.end(),
+                           [engine](const Entry& e) { return e.engine == engine; });
+    assert(it != leased_.end());
+    entry = *it;
+    *it = leased_.back();
+    leased_.pop_back();
+  }
+
+  if (config_.maxLeasesPerEngine != 0 && entry.leaseCount >= config_.maxLeasesPerEngine) {
+    recycle = true;
+  }
+
+  if (!recycle && config_.resetEngine) {
+    try {
+      EngineScope scope(engine);
+      recycle = !config_.resetEngine(engine);
+    } catch (...) {
+      recycle = true;
+    }
+  } else {
+    recycle = true;
+  }
+
+  if (recycle) {
+    // no replacement is built here, that would stall the returning thread.
+    destroyEngine(engine);
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      statistics_.recycled++;
+    }
+    if (config_.refillInBackground) {
+      scheduleRefill();
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    statistics_.reset++;
+    if (idle_.size() < config_.poolSize) {
+      idle_.push_back(entry);
+      return;
+    }
+  }
+  // created on demand when the pool was empty, and the pool is full again
+  destroyEngine(engine);
+}
+
+void EnginePool::scheduleRefill() {
+  std::lock_guard<std::mutex> lock(lock_);
+  if (refillScheduled_) return;
+  try {
+    if (!refillThread_) {
+      refillThread_ = std::make_unique<ThreadPool>(1);
+    }
+    Message refill(
+        [](Message& message) {
+          auto pool = static_cast<EnginePool*>(message.ptr0);
+          {
+            // recycles from now on need another round
+            std::lock_guard<std::mutex> lock(pool->lock_);
+            pool->refillScheduled_ = false;
+          }
+          try {
+            pool->prewarm();
+          } catch (...) {
+            // nobody to report to, the next acquire() builds on demand and throws there
+          }
+        },
+        nullptr);
+    refill.ptr0 = this;
+    refill.name = "EnginePool::refill";
+    refillThread_->postMessage(refill);
+    refillScheduled_ = true;
+  } catch (...) {
+    // can't start a thread, acquire() builds on demand
+  }
+}
+
+EnginePool::Statistics EnginePool::statistics() {
+  std::lock_guard<std::mutex> lock(lock_);
+  auto ret = statistics_;
+  ret.idle = idle_.size();
+  ret.leased = leased_.size();
+  return ret;
+}
+
+size_t EnginePool::idleCount() {
+  std::lock_guard<std::mutex> lock(lock_);
+  return idle_.size();
+}
+
+size_t EnginePool::leasedCount() {
+  std::lock_guard<std::mutex> lock(lock_);
+  return leased_.size();
+}
+
+size_t EnginePool::recycledCount() {
+  std::lock_guard<std::mutex> lock(lock_);
+  return statistics_.recycled;
+}
+
+}  // namespace script::utils
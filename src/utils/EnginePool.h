@@ -0,0 +1,205 @@
+/*
+ * Tencent is pleased to support the open source community by making ScriptX available.
+ * Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "../Engine.h"
+#include "../foundation.h"
+#include "ThreadPool.h"
+
+namespace script::utils {
+
+/**
+ * A pool of pre-initialized engines, so request handlers skip engine construction,
+ * native class registration and bootstrap scripts.
+ *
+ * usage:
+ * <code>
+ * EnginePool::Config config;
+ * config.poolSize = 4;
+ * config.engineFactory = []() -> ScriptEngine* { return new ScriptEngineImpl(); };
+ * config.nativeClasses = {myClassDefine.getNativeRegister()};
+ * config.baseScripts = {bootstrapSource};
+ * config.resetEngine = [](ScriptEngine* engine) { engine->eval("resetState()"); return true; };
+ *
+ * EnginePool pool(std::move(config));
+ *
+ * // in a request handler
+ * auto lease = pool.acquire();
+ * EngineScope scope(lease.get());
+ * lease->eval("handle()");
+ * // lease goes back to the pool when destructed
+ * </code>
+ *
+ * The pool is thread-safe; an engine is only leased to one user at a time.
+ * All leases must be returned before the pool is destructed.
+ * Recycled engines are rebuilt on a background thread (see Config::refillInBackground),
+ * so engines are used on other threads than the one that created them.
+ */
+class EnginePool {
+ public:
+  struct Config {
+    // number of engines kept initialized and idle
+    size_t poolSize = 1;
+
+    // required, creates a bare engine. ie. `new ScriptEngineImpl()` with backend options.
+    // returning nullptr is an error, reported as std::runtime_error
+    std::function<ScriptEngine*()> engineFactory;
+
+    // registered to each new engine, ie. ClassDefine::getNativeRegister()
+    std::vector<NativeRegister> nativeClasses;
+
+    // evaluated in order in each new engine, after nativeClasses
+    std::vector<std::string> baseScripts;
+
+    // optional, called in EngineScope after baseScripts
+    std::function<void(ScriptEngine* engine)> initializer;
+
+    /**
+     * called in EngineScope when a lease is returned, to reset the global state left by the user.
+     * return false (or throw) to recycle the engine instead.
+     * When not set, returned engines are always recycled.
+     */
+    std::function<bool(ScriptEngine* engine)> resetEngine;
+
+    // recycle an engine after being leased this many times, 0 for unlimited
+    size_t maxLeasesPerEngine = 0;
+
+    /**
+     * rebuild recycled engines on a background thread (started by the first recycle),
+     * so that acquire() finds an idle engine instead of initializing one.
+     * When false, the replacement is built by the next acquire(), or call prewarm().
+     */
+    bool refillInBackground = true;
+  };
+
+  struct Statistics {
+    size_t idle = 0;
+    size_t leased = 0;
+    // engines ever created by the pool
+    size_t created = 0;
+    // returned engines reused after resetEngine
+    size_t reset = 0;
+    // returned engines destroyed, replaced in the background, or on the next acquire() or prewarm()
+    size_t recycled = 0;
+  };
+
+  /**
+   * An engine leased from the pool, returned to the pool on destruction.
+   */
+  class Lease {
+   public:
+    Lease() = default;
+
+    Lease(Lease&& other) noexcept;
+
+    Lease& operator=(Lease&& other) noexcept;
+
+    SCRIPTX_DISALLOW_COPY(Lease);
+
+    ~Lease();
+
+    ScriptEngine* get() const { return engine_; }
+
+    ScriptEngine* operator->() const { return engine_; }
+
+    explicit operator bool() const { return engine_ != nullptr; }
+
+    /**
+     * destroy the engine instead of resetting it on return,
+     * ie. the engine hit its heap limit or script state is broken.
+     */
+    void markForRecycle() { recycle_ = true; }
+
+    /**
+     * return the engine to the pool now, the lease is empty afterwards.
+     */
+    void release();
+
+   private:
+    friend class EnginePool;
+
+    Lease(EnginePool* pool, ScriptEngine* engine) : pool_(pool), engine_(engine) {}
+
+    EnginePool* pool_ = nullptr;
+    ScriptEngine* engine_ = nullptr;
+    bool recycle_ = false;
+  };
+
+  /**
+   * create the pool and initialize poolSize engines.
+   * throws std::runtime_error without engineFactory,
+   * exceptions from engine initialization are propagated.
+   */
+  explicit EnginePool(Config config);
+
+  SCRIPTX_DISALLOW_COPY_AND_MOVE(EnginePool);
+
+  ~EnginePool();
+
+  /**
+   * lease an idle engine, a new one is initialized when none is idle.
+   */
+  Lease acquire();
+
+  /**
+   * initialize engines until poolSize engines are idle, ie. after engines got recycled.
+   */
+  void prewarm();
+
+  Statistics statistics();
+
+  size_t idleCount();
+
+  size_t leasedCount();
+
+  size_t recycledCount();
+
+ private:
+  struct Entry {
+    ScriptEngine* engine = nullptr;
+    size_t leaseCount = 0;
+  };
+
+  Entry createEngine();
+
+  void giveBack(ScriptEngine* engine, bool recycle);
+
+  // post a prewarm() to refillThread_, unless one is pending. never throws
+  void scheduleRefill();
+
+  static void destroyEngine(ScriptEngine* engine);
+
+  const Config config_;
+  std::mutex lock_;
+  std::deque<Entry> idle_;
+  // lease count of engines currently leased
+  std::vector<Entry> leased_;
+  Statistics statistics_;
+  // single worker for scheduleRefill, created on first use
+  std::unique_ptr<ThreadPool> refillThread_;
+  bool refillScheduled_ = false;
+};
+
+}  // namespace script::utils
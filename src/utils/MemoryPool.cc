@@ -0,0 +1,250 @@
+/*
+ * Tencent is pleased to support the open source community by making ScriptX available.
+ * Copyright (C) 2021 THL A29 Limited, a Tencent company.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MemoryPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include "ThreadLocal.h"
+
+namespace script::internal {
+
+// bumped by every ThreadCachingPoolCore::close(), so threads notice stale magazines
+static std::atomic<std::uint64_t> closedPoolCount_{0};
+
+struct ThreadCache {
+  struct Magazine {
+    std::shared_ptr<ThreadCachingPoolCore> pool;
+    std::vector<void*> objects;
+  };
+
+  std::vector<Magazine> magazines;
+  std::size_t lastHit = 0;
+  std::uint64_t seenClosedPoolCount = 0;
+
+  ThreadCache() = default;
+
+  ~ThreadCache() {
+    // thread exit, give everything back
+    for (auto& m : magazines) {
+      m.pool->spill(m.objects, m.objects.size());
+    }
+  }
+
+  /**
+   * drop magazines of pools closed since last check, releasing our reference to their cores.
+   * slab memory is already freed by close(), only objects outside slabs are deleted here.
+   */
+  void dropClosedPools() {
+    auto closedCount = closedPoolCount_.load(std::memory_order_acquire);
+    if (closedCount == seenClosedPoolCount) return;
+    seenClosedPoolCount = closedCount;
+
+    for (auto it = magazines.begin(); it != magazines.end();) {
+      bool closed;
+      {
+        std::lock_guard<std::mutex> lk(it->pool->depotLock_);
+        closed = it->pool->closed_;
+      }
+      if (closed) {
+        it->pool->spill(it->objects, it->objects.size());
+        it = magazines.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    lastHit = 0;
+  }
+
+  SCRIPTX_DISALLOW_COPY_AND_MOVE(ThreadCache);
+};
+
+SCRIPTX_THREAD_LOCAL(ThreadCache, threadCache_);
+
+ThreadCachingPoolCore::ThreadCachingPoolCore(const TypeInfo& typeInfo, std::size_t capacity,
+                                             bool preAllocate)
+    : typeInfo_(typeInfo), capacity_(capacity) {
+  if (preAllocate && capacity_ > 0) {
+    std::lock_guard<std::mutex> lk(depotLock_);
+    depot_.reserve(capacity_);
+    allocateSlabLocked(capacity_, depot_);
+  }
+}
+
+ThreadCachingPoolCore::~ThreadCachingPoolCore() {
+  if (!closed_) reclaimLocked();
+}
+
+std::vector<void*>& ThreadCachingPoolCore::localMagazine() {
+  auto& cache = getThreadLocal(threadCache_);
+  cache.dropClosedPools();
+  auto& magazines = cache.magazines;
+  if (cache.lastHit < magazines.size() && magazines[cache.lastHit].pool.get() == this) {
+    return magazines[cache.lastHit].objects;
+  }
+
+  for (std::size_t i = 0; i < magazines.size(); ++i) {
+    if (magazines[i].pool.get() == this) {
+      cache.lastHit = i;
+      return magazines[i].objects;
+    }
+  }
+
+  // first use on this thread
+  auto& m = magazines.emplace_back();
+  m.pool = shared_from_this();
+  m.objects.reserve(kMagazineSize * 2);
+  cache.lastHit = magazines.size() - 1;
+  return m.objects;
+}
+
+void* ThreadCachingPoolCore::obtain() {
+  auto& magazine = localMagazine();
+  if (magazine.empty()) {
+    refill(magazine);
+    if (magazine.empty()) {
+      return typeInfo_.create();
+    }
+  }
+  auto item = magazine.back();
+  magazine.pop_back();
+  return item;
+}
+
+void ThreadCachingPoolCore::release(void* item) {
+  auto& magazine = localMagazine();
+  if (magazine.size() >= kMagazineSize * 2) {
+    // keep the other half, so that alternating obtain/release don't spill/refill every time
+    spill(magazine, kMagazineSize);
+  }
+  magazine.push_back(item);
+}
+
+void ThreadCachingPoolCore::cleanup() {
+  auto& magazine = localMagazine();
+  spill(magazine, magazine.size());
+
+  std::lock_guard<std::mutex> lk(depotLock_);
+  auto slabEnd = std::partition(depot_.begin(), depot_.end(),
+                                [this](void* item) { return isSlabObjectLocked(item); });
+  for (auto it = slabEnd; it != depot_.end(); ++it) {
+    typeInfo_.destroy(*it);
+  }
+  depot_.erase(slabEnd, depot_.end());
+  heapObjects_ = 0;
+}
+
+void ThreadCachingPoolCore::close() {
+  // may be the last reference besides magazines of other threads
+  auto self = shared_from_this();
+
+  auto& magazines = getThreadLocal(threadCache_).magazines;
+  for (auto it = magazines.begin(); it != magazines.end(); ++it) {
+    if (it->pool.get() == this) {
+      spill(it->objects, it->objects.size());
+      magazines.erase(it);
+      break;
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lk(depotLock_);
+    closed_ = true;
+    reclaimLocked();
+  }
+  closedPoolCount_.fetch_add(1, std::memory_order_release);
+}
+
+void ThreadCachingPoolCore::reclaimLocked() {
+  // every object is released by now, those still cached by other threads are either
+  // inside slabs (destructed here) or deleted when that thread drops its magazine.
+  for (auto item : depot_) {
+    if (!isSlabObjectLocked(item)) typeInfo_.destroy(item);
+  }
+  depot_.clear();
+  depot_.shrink_to_fit();
+  heapObjects_ = 0;
+
+  for (auto& slab : slabs_) {
+    for (auto p = slab.begin; p != slab.end; p += typeInfo_.size) {
+      typeInfo_.destruct(p);
+    }
+    ::operator delete(slab.begin, std::align_val_t(typeInfo_.align));
+  }
+  // slab ranges are kept to tell stale slab objects apart in spill(), they are never dereferenced
+  slabObjects_ = 0;
+}
+
+void ThreadCachingPoolCore::allocateSlabLocked(std::size_t count, std::vector<void*>& out) {
+  auto begin =
+      static_cast<char*>(::operator new(count * typeInfo_.size, std::align_val_t(typeInfo_.align)));
+  auto end = begin + count * typeInfo_.size;
+  for (auto p = begin; p != end; p += typeInfo_.size) {
+    typeInfo_.construct(p);
+    out.push_back(p);
+  }
+
+  Slab slab{begin, end};
+  slabs_.insert(std::upper_bound(slabs_.begin(), slabs_.end(), slab,
+                                 [](const Slab& a, const Slab& b) { return a.begin < b.begin; }),
+                slab);
+  slabObjects_ += count;
+}
+
+bool ThreadCachingPoolCore::isSlabObjectLocked(void* item) const {
+  auto p = static_cast<char*>(item);
+  auto it = std::upper_bound(slabs_.begin(), slabs_.end(), p,
+                             [](char* p, const Slab& slab) { return p < slab.begin; });
+  return it != slabs_.begin() && p < std::prev(it)->end;
+}
+
+void ThreadCachingPoolCore::refill(std::vector<void*>& magazine) {
+  std::lock_guard<std::mutex> lk(depotLock_);
+  auto count = (std::min)(kMagazineSize, depot_.size());
+  if (count > 0) {
+    for (auto it = depot_.end() - count; it != depot_.end(); ++it) {
+      if (!isSlabObjectLocked(*it)) --heapObjects_;
+    }
+    magazine.insert(magazine.end(), depot_.end() - count, depot_.end());
+    depot_.resize(depot_.size() - count);
+  } else if (slabObjects_ < capacity_) {
+    allocateSlabLocked((std::min)(kMagazineSize, capacity_ - slabObjects_), magazine);
+  }
+}
+
+void ThreadCachingPoolCore::spill(std::vector<void*>& magazine, std::size_t count) {
+  auto begin = magazine.end() - static_cast<std::ptrdiff_t>(count);
+  {
+    std::lock_guard<std::mutex> lk(depotLock_);
+    for (auto it = begin; it != magazine.end(); ++it) {
+      if (isSlabObjectLocked(*it)) {
+        // freed together with its slab
+        if (!closed_) depot_.push_back(*it);
+      } else if (!closed_ && slabObjects_ + heapObjects_ < capacity_) {
+        // slab objects count too, so retained memory stays within capacity
+        depot_.push_back(*it);
+        ++heapObjects_;
+      } else {
+        typeInfo_.destroy(*it);
+      }
+    }
+  }
+  magazine.erase(begin, magazine.end());
+}
+
+}  // namespace script::internal
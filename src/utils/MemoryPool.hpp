@@ -18,9 +18,11 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdlib>
 #include <limits>
 #include <memory>
 #include <mutex>
+#include <new>
 #include <type_traits>
 #include <vector>
 
@@ -44,6 +46,139 @@ struct MemoryPoolLockTrait<false> {
   };
 };
 
+/**
+ * Type-erased core of utils::ThreadCachingMemoryPool, see MemoryPool.cc.
+ *
+ * Each thread keeps a magazine (a small stack of free objects) per pool, obtain/release only touch
+ * that magazine. An empty magazine is refilled from the shared depot, and a full one spills half
+ * of it back, both in batches of kMagazineSize under depotLock_.
+ */
+class ThreadCachingPoolCore : public std::enable_shared_from_this<ThreadCachingPoolCore> {
+ public:
+  struct TypeInfo {
+    std::size_t size;
+    std::size_t align;
+    // placement new / destruct, for objects inside slab
+    void (*construct)(void*);
+    void (*destruct)(void*);
+    // new / delete, for objects outside slab
+    void* (*create)();
+    void (*destroy)(void*);
+  };
+
+  static constexpr std::size_t kMagazineSize = 32;
+
+  ThreadCachingPoolCore(const TypeInfo& typeInfo, std::size_t capacity, bool preAllocate);
+
+  ~ThreadCachingPoolCore();
+
+  void* obtain();
+
+  void release(void* item);
+
+  void cleanup();
+
+  void close();
+
+  SCRIPTX_DISALLOW_COPY_AND_MOVE(ThreadCachingPoolCore);
+
+ private:
+  struct Slab {
+    char* begin;
+    char* end;
+  };
+
+  const TypeInfo typeInfo_;
+  const std::size_t capacity_;
+
+  std::mutex depotLock_;
+  std::vector<void*> depot_;
+  // sorted by address
+  std::vector<Slab> slabs_;
+  std::size_t slabObjects_ = 0;
+  // objects in depot_ not from a slab, slabObjects_ + heapObjects_ <= capacity_
+  std::size_t heapObjects_ = 0;
+  bool closed_ = false;
+
+  std::vector<void*>& localMagazine();
+
+  void reclaimLocked();
+
+  void allocateSlabLocked(std::size_t count, std::vector<void*>& out);
+
+  bool isSlabObjectLocked(void* item) const;
+
+  void refill(std::vector<void*>& magazine);
+
+  void spill(std::vector<void*>& magazine, std::size_t count);
+
+  friend struct ThreadCache;
+};
+
+}  // namespace internal
+
+namespace utils {
+
+template <typename T, bool ThreadSafe>
+class MemoryPool;
+
+template <typename T>
+class ThreadCachingMemoryPool;
+
+}  // namespace utils
+
+namespace internal {
+
+/**
+ * std allocator that takes single-element allocations from a pool of raw storage.
+ * @tparam Pool a MemoryPool or ThreadCachingMemoryPool of aligned_storage for T
+ */
+template <typename T, typename Pool>
+struct PoolAllocatorBase {
+ private:
+  using ElementType = std::aligned_storage_t<sizeof(T), alignof(T)>;
+  std::shared_ptr<Pool> pool_;
+
+ public:
+  using value_type = T;
+
+  PoolAllocatorBase(size_t cap, bool preAllocate)
+      : pool_(std::make_shared<Pool>(cap, preAllocate)) {}
+
+  T* allocate(std::size_t n) {
+    if (n >
+        /* workaround windows.h "max()" marco */
+        (std::numeric_limits<std::size_t>::max)() / sizeof(T)) {
+      throw std::bad_alloc();
+    }
+
+    if (n == 1) {
+      return reinterpret_cast<T*>(pool_->obtain());
+    }
+
+    if (auto p = static_cast<T*>(std::malloc(n * sizeof(T)))) {
+      return p;
+    }
+
+    throw std::bad_alloc();
+  }
+
+  void deallocate(T* p, std::size_t n) noexcept {
+    if (n == 1) {
+      pool_->release(reinterpret_cast<ElementType*>(p));
+    } else {
+      std::free(p);
+    }
+  }
+
+  template <class U, typename UPool>
+  bool operator==(const PoolAllocatorBase<U, UPool>& other) const {
+    return false;
+  }
+
+  bool operator==(const PoolAllocatorBase& other) const { return pool_ == other.pool_; }
+};
+
 }  // namespace internal
 
 namespace utils {
@@ -77,7 +212,9 @@ class MemoryPool {
   std::vector<T*> pool_;
   LockType poolLock_;
 
-  struct AllocatorBase;
+  using AllocatorBase =
+      internal::PoolAllocatorBase<T, MemoryPool<std::aligned_storage_t<sizeof(T), alignof(T)>,
+                                                ThreadSafe>>;
 };
 
 template <typename T, bool ThreadSafe>
@@ -131,62 +268,86 @@ void MemoryPool<T, ThreadSafe>::cleanup() {
 }
 
 template <typename T, bool ThreadSafe>
-struct MemoryPool<T, ThreadSafe>::AllocatorBase {
- private:
-  using ElementType = std::aligned_storage_t<sizeof(T), alignof(T)>;
-  std::shared_ptr<MemoryPool<ElementType, ThreadSafe>> pool_;
+template <size_t capacity, bool preloadAllocate>
+struct MemoryPool<T, ThreadSafe>::Allocator : public MemoryPool<T, ThreadSafe>::AllocatorBase {
+  template <typename U>
+  struct rebind {
+    using other = typename MemoryPool<U, ThreadSafe>::template Allocator<capacity, preloadAllocate>;
+  };
 
- public:
-  using value_type = T;
+  Allocator() : MemoryPool<T, ThreadSafe>::AllocatorBase(capacity, preloadAllocate) {}
 
-  AllocatorBase(size_t cap, bool preAllocate)
-      : pool_(std::make_shared<MemoryPool<ElementType, ThreadSafe>>(cap, preAllocate)) {}
+  template <class U>
+  constexpr Allocator(const U&) noexcept : Allocator() {}
+};
 
-  T* allocate(std::size_t n) {
-    if (n >
-        /* workaround windows.h "max()" marco */
-        (std::numeric_limits<std::size_t>::max)() / sizeof(T)) {
-      throw std::bad_alloc();
-    }
+/**
+ * A MemoryPool that scales with threads.
+ *
+ * Every thread caches free objects in its own magazine, and only exchanges them with a shared
+ * depot in batches, so obtain/release from different threads don't contend on a single lock.
+ * Objects are carved from contiguous slabs, up to capacity objects in total. Beyond that,
+ * objects are allocated with new, and only kept in the depot while slab objects plus kept ones
+ * stay within capacity. On top of that each thread caches up to 2 * kMagazineSize objects.
+ *
+ * Destructing the pool frees the depot and every slab at once. Objects still cached by other
+ * threads are dropped the next time those threads use any ThreadCachingMemoryPool (or exit).
+ * Objects not from a slab, like those obtained before and released here,
+ * must have been created by new T().
+ *
+ * @tparam T t must have a default constructor and visible destructor.
+ */
+template <typename T>
+class ThreadCachingMemoryPool {
+ public:
+  explicit ThreadCachingMemoryPool(std::size_t capacity, bool preAllocate = false)
+      : core_(std::make_shared<internal::ThreadCachingPoolCore>(typeInfo(), capacity,
+                                                                preAllocate)) {}
 
-    if (n == 1) {
-      return reinterpret_cast<T*>(pool_->obtain());
-    }
+  ~ThreadCachingMemoryPool() { core_->close(); }
 
-    if (auto p = static_cast<T*>(std::malloc(n * sizeof(T)))) {
-      return p;
-    }
+  T* obtain() { return static_cast<T*>(core_->obtain()); }
 
-    throw std::bad_alloc();
-  }
+  void release(T* item) { core_->release(item); }
 
-  void deallocate(T* p, std::size_t n) noexcept {
-    if (n == 1) {
-      pool_->release(reinterpret_cast<ElementType*>(p));
-    } else {
-      std::free(p);
-    }
-  }
+  /**
+   * return objects cached by current thread to the depot, and delete those not from a slab.
+   */
+  void cleanup() { core_->cleanup(); }
 
-  template <class U, bool _ThreadSafe>
-  bool operator==(const typename MemoryPool<U, ThreadSafe>::AllocatorBase& other) const {
-    return false;
-  }
+  SCRIPTX_DISALLOW_COPY_AND_MOVE(ThreadCachingMemoryPool);
 
-  bool operator==(const MemoryPool<T, ThreadSafe>::AllocatorBase& other) const {
-    return pool_ == other.pool_;
+  template <size_t Capacity, bool PreloadAllocate = true>
+  struct Allocator;
+
+ private:
+  std::shared_ptr<internal::ThreadCachingPoolCore> core_;
+
+  using AllocatorBase = internal::PoolAllocatorBase<
+      T, ThreadCachingMemoryPool<std::aligned_storage_t<sizeof(T), alignof(T)>>>;
+
+  static const internal::ThreadCachingPoolCore::TypeInfo& typeInfo() {
+    static const internal::ThreadCachingPoolCore::TypeInfo info{
+        sizeof(T),
+        alignof(T),
+        [](void* p) { new (p) T(); },
+        [](void* p) { static_cast<T*>(p)->~T(); },
+        []() -> void* { return new T(); },
+        [](void* p) { delete static_cast<T*>(p); }};
+    return info;
   }
 };
 
-template <typename T, bool ThreadSafe>
+template <typename T>
 template <size_t capacity, bool preloadAllocate>
-struct MemoryPool<T, ThreadSafe>::Allocator : public MemoryPool<T, ThreadSafe>::AllocatorBase {
+struct ThreadCachingMemoryPool<T>::Allocator : public ThreadCachingMemoryPool<T>::AllocatorBase {
   template <typename U>
   struct rebind {
-    using other = typename MemoryPool<U, ThreadSafe>::template Allocator<capacity, preloadAllocate>;
+    using other =
+        typename ThreadCachingMemoryPool<U>::template Allocator<capacity, preloadAllocate>;
   };
 
-  Allocator() : MemoryPool<T, ThreadSafe>::AllocatorBase(capacity, preloadAllocate) {}
+  Allocator() : ThreadCachingMemoryPool<T>::AllocatorBase(capacity, preloadAllocate) {}
 
   template <class U>
   constexpr Allocator(const U&) noexcept : Allocator() {}
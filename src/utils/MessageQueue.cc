@@ -93,6 +93,9 @@ void Message::performCleanup() {
   handlerProc = cleanupProc = nullptr;
   dueTime = std::chrono::nanoseconds(0);
   messageId = 0;
+  ingressNext = nullptr;
+  sequence = 0;
+  cancelled = false;
 }
 
 void Message::handle() {
@@ -110,10 +113,14 @@ MessageQueue::MessageQueue(std::size_t maxMessageInQueue)
       messagePool_(kDefaultPoolSize),
       shutdown_(ShutdownType::kNone),
       interrupt_(false),
+      ingress_(nullptr),
       queueMutex_(),
       queueNotEmptyCondition_(),
       queueNotFullCondition_(),
       queue_(),
+      cancelledCount_(0),
+      sequenceCounter_(0),
+      messageIndex_(),
       messageIdCounter_(1),
       workerCount_(0),
       workerQuitCondition_(),
@@ -123,7 +130,9 @@ MessageQueue::~MessageQueue() { shutdownNow(true); }
 
 std::unique_ptr<InplaceMessage> MessageQueue::obtainInplaceMessage(
     InplaceMessage::HandlerPorc* handlerProc) {
-  auto msg = messagePool_.obtain();
+  // not from messagePool_, the unique_ptr may delete it without ever being posted.
+  // once posted, it's handed to messagePool_ on release like any other message.
+  auto msg = new Message();
   // InplaceMessage is essentially a Message with some extra non-virtual method.
   // so it's safe to cast
   msg->handlerProc = reinterpret_cast<void (*)(Message&)>(reinterpret_cast<void*>(handlerProc));
@@ -155,10 +164,8 @@ void MessageQueue::shutdownNow(bool awaitTermination) {
   {
     std::lock_guard<std::mutex> lk(queueMutex_);
     shutdown_ = ShutdownType::kNow;
-    for (auto r : queue_) {
-      releaseMessage(r);
-    }
-    queue_.clear();
+    drainIngressLocked();
+    clearLocked();
   }
 
   // wake up postMessage
@@ -209,7 +216,7 @@ void MessageQueue::interrupt() {
   queueNotEmptyCondition_.notify_all();
 }
 
-bool MessageQueue::isQueueFull() const { return queue_.size() >= maxMessageInQueue_; }
+bool MessageQueue::isQueueFull() const { return messageCountLocked() >= maxMessageInQueue_; }
 
 void MessageQueue::awaitNotFullLocked(std::unique_lock<std::mutex>& lock) {
   if (isQueueFull() && LoopQueueGuard::isCallerNestedInsideLoop(this)) {
@@ -221,15 +228,25 @@ void MessageQueue::awaitNotFullLocked(std::unique_lock<std::mutex>& lock) {
   queueNotFullCondition_.wait(lock, [this] { return !isQueueFull(); });
 }
 
-int32_t MessageQueue::postMessage(Message* msg, int64_t delayNanos) {
+int32_t MessageQueue::nextMessageId() {
   auto id = messageIdCounter_++;
   // avoid a "0 id"
   while (id == 0) {
     id = messageIdCounter_++;
   }
+  return id;
+}
+
+int32_t MessageQueue::postMessage(Message* msg, int64_t delayNanos) {
+  auto id = nextMessageId();
 
   msg->dueTime = timestamp() + std::chrono::nanoseconds(delayNanos);
   msg->messageId = id;
+  msg->sequence = sequenceCounter_.fetch_add(1, std::memory_order_relaxed);
+
+  if (delayNanos <= 0 && useIngress()) {
+    return postToIngress(msg);
+  }
 
   {
     std::unique_lock<std::mutex> lk(queueMutex_);
@@ -238,37 +255,231 @@ int32_t MessageQueue::postMessage(Message* msg, int64_t delayNanos) {
       releaseMessage(msg);
       return 0;
     }
-    auto pos = findInsertPositionLocked(msg->dueTime, msg->priority);
-    queue_.insert(pos, msg);
+    enqueueLocked(msg);
   }
   queueNotEmptyCondition_.notify_all();
 
   return id;
 }
 
-std::deque<Message*>::const_iterator MessageQueue::findInsertPositionLocked(
-    std::chrono::nanoseconds dueTime, int32_t priority) const {
-  if (queue_.empty()) {
-    return queue_.end();
+int32_t MessageQueue::postToIngress(Message* msg) {
+  auto id = msg->messageId;
+  if (shutdown_ == ShutdownType::kNow) {
+    releaseMessage(msg);
+    return 0;
+  }
+
+  auto head = ingress_.load(std::memory_order_relaxed);
+  do {
+    msg->ingressNext = head;
+  } while (!ingress_.compare_exchange_weak(head, msg, std::memory_order_acq_rel,
+                                           std::memory_order_relaxed));
+
+  if (head == nullptr) {
+    // First message since last drain. The looper drains ingress and then waits while holding
+    // queueMutex_, acquiring it here makes sure the notification is not lost in between.
+    // Following posts see a non-empty ingress and skip both the lock and the notification.
+    { std::lock_guard<std::mutex> lk(queueMutex_); }
+    queueNotEmptyCondition_.notify_all();
+  }
+
+  if (shutdown_ == ShutdownType::kNow) {
+    // raced with shutdownNow(), which may have drained ingress before our push.
+    std::lock_guard<std::mutex> lk(queueMutex_);
+    drainIngressLocked();
+    clearLocked();
+  }
+
+  return id;
+}
+
+size_t MessageQueue::postMessages(Message** messages, size_t count, int64_t delayNanos,
+                                  int32_t* ids) {
+  if (count == 0) return 0;
+
+  // one timestamp for the whole batch, so they are ordered by priority then post order
+  auto dueTime = timestamp() + std::chrono::nanoseconds(delayNanos);
+  auto sequence = sequenceCounter_.fetch_add(count, std::memory_order_relaxed);
+  for (size_t i = 0; i < count; ++i) {
+    messages[i]->dueTime = dueTime;
+    messages[i]->messageId = nextMessageId();
+    messages[i]->sequence = sequence + i;
+    if (ids) ids[i] = messages[i]->messageId;
+  }
+
+  if (delayNanos <= 0 && useIngress()) {
+    if (shutdown_ == ShutdownType::kNow) {
+      for (size_t i = 0; i < count; ++i) {
+        if (ids) ids[i] = 0;
+        releaseMessage(messages[i]);
+      }
+      return 0;
+    }
+
+    // link the batch LIFO, and push it with a single CAS
+    for (size_t i = 1; i < count; ++i) {
+      messages[i]->ingressNext = messages[i - 1];
+    }
+    auto head = ingress_.load(std::memory_order_relaxed);
+    do {
+      messages[0]->ingressNext = head;
+    } while (!ingress_.compare_exchange_weak(head, messages[count - 1], std::memory_order_acq_rel,
+                                             std::memory_order_relaxed));
+
+    if (head == nullptr) {
+      { std::lock_guard<std::mutex> lk(queueMutex_); }
+      queueNotEmptyCondition_.notify_all();
+    }
+
+    if (shutdown_ == ShutdownType::kNow) {
+      std::lock_guard<std::mutex> lk(queueMutex_);
+      drainIngressLocked();
+      clearLocked();
+    }
+    return count;
+  }
+
+  size_t posted = 0;
+  {
+    std::unique_lock<std::mutex> lk(queueMutex_);
+    for (; posted < count; ++posted) {
+      if (posted > 0 && isQueueFull()) {
+        // the batch is larger than the free space, wake up the looper to drain what is
+        // posted so far, otherwise both sides wait for each other.
+        queueNotEmptyCondition_.notify_all();
+      }
+      // only blocks when queue is bounded and full
+      awaitNotFullLocked(lk);
+      if (shutdown_ == ShutdownType::kNow) break;
+      enqueueLocked(messages[posted]);
+    }
+    for (size_t i = posted; i < count; ++i) {
+      if (ids) ids[i] = 0;
+      releaseMessage(messages[i]);
+    }
+  }
+  queueNotEmptyCondition_.notify_all();
+
+  return posted;
+}
+
+void MessageQueue::drainIngressLocked() {
+  auto head = ingress_.exchange(nullptr, std::memory_order_acq_rel);
+  if (head == nullptr) return;
+
+  // ingress is LIFO, reverse it to post order
+  Message* ordered = nullptr;
+  while (head) {
+    auto next = head->ingressNext;
+    head->ingressNext = ordered;
+    ordered = head;
+    head = next;
   }
 
-  // search backwords, since add to queue-end is the most common case
-  auto it = queue_.end() - 1;
-  while (it != queue_.begin() && (*it)->dueTime >= dueTime) {
-    --it;
+  while (ordered) {
+    auto next = ordered->ingressNext;
+    ordered->ingressNext = nullptr;
+    enqueueLocked(ordered);
+    ordered = next;
   }
+}
+
+void MessageQueue::enqueueLocked(Message* msg) {
+  queue_.push_back(msg);
+  siftUpLocked(queue_.size() - 1);
+  messageIndex_.emplace(msg->messageId, msg);
+}
+
+bool MessageQueue::isBefore(const Message* lhs, const Message* rhs) {
+  if (lhs->dueTime != rhs->dueTime) return lhs->dueTime < rhs->dueTime;
+  // smaller number has higher priority
+  if (lhs->priority != rhs->priority) return lhs->priority < rhs->priority;
+  return lhs->sequence < rhs->sequence;
+}
+
+void MessageQueue::siftUpLocked(size_t index) {
+  auto msg = queue_[index];
+  while (index > 0) {
+    auto parent = (index - 1) / 2;
+    if (!isBefore(msg, queue_[parent])) break;
+    queue_[index] = queue_[parent];
+    index = parent;
+  }
+  queue_[index] = msg;
+}
+
+void MessageQueue::siftDownLocked(size_t index) {
+  auto size = queue_.size();
+  auto msg = queue_[index];
+  while (true) {
+    auto child = index * 2 + 1;
+    if (child >= size) break;
+    if (child + 1 < size && isBefore(queue_[child + 1], queue_[child])) ++child;
+    if (!isBefore(queue_[child], msg)) break;
+    queue_[index] = queue_[child];
+    index = child;
+  }
+  queue_[index] = msg;
+}
 
-  // search by due-time
-  while (it != queue_.end() && (*it)->dueTime < dueTime) {
-    ++it;
+Message* MessageQueue::frontLocked() {
+  while (!queue_.empty() && queue_.front()->cancelled) {
+    auto msg = queue_.front();
+    --cancelledCount_;
+    queue_.front() = queue_.back();
+    queue_.pop_back();
+    if (!queue_.empty()) siftDownLocked(0);
+    releaseMessage(msg);
   }
+  return queue_.empty() ? nullptr : queue_.front();
+}
+
+void MessageQueue::popFrontLocked() {
+  messageIndex_.erase(queue_.front()->messageId);
+  queue_.front() = queue_.back();
+  queue_.pop_back();
+  if (!queue_.empty()) siftDownLocked(0);
+}
 
-  // search by priority
-  while (it != queue_.end() && (*it)->dueTime == dueTime && (*it)->priority <= priority) {
-    ++it;
+void MessageQueue::cancelLocked(Message* msg) {
+  messageIndex_.erase(msg->messageId);
+  // cleanup now as removeMessage promised, but keep the ordering keys for the heap
+  if (msg->cleanupProc) {
+    msg->cleanupProc(*msg);
   }
+  msg->handlerProc = msg->cleanupProc = nullptr;
+  msg->cancelled = true;
+  ++cancelledCount_;
+}
+
+void MessageQueue::compactLocked() {
+  // amortized O(1): only when tombstones outnumber live messages
+  constexpr size_t kMinCompactCount = 64;
+  if (cancelledCount_ < kMinCompactCount || cancelledCount_ < messageCountLocked()) return;
+  purgeCancelledLocked();
+}
+
+void MessageQueue::purgeCancelledLocked() {
+  auto live = std::remove_if(queue_.begin(), queue_.end(), [this](Message* msg) {
+    if (!msg->cancelled) return false;
+    releaseMessage(msg);
+    return true;
+  });
+  queue_.erase(live, queue_.end());
+  cancelledCount_ = 0;
+
+  // O(n) heapify, std heap is a max-heap so reverse the order
+  std::make_heap(queue_.begin(), queue_.end(),
+                 [](const Message* lhs, const Message* rhs) { return isBefore(rhs, lhs); });
+}
 
-  return it;
+void MessageQueue::clearLocked() {
+  for (auto r : queue_) {
+    releaseMessage(r);
+  }
+  queue_.clear();
+  messageIndex_.clear();
+  cancelledCount_ = 0;
 }
 
 bool MessageQueue::removeMessageIf(
@@ -276,19 +487,20 @@ bool MessageQueue::removeMessageIf(
   bool removed = false;
   {
     std::lock_guard<std::mutex> lk(queueMutex_);
-    for (auto it = queue_.begin(); it != queue_.end();) {
-      auto type = pred(**it);
+    drainIngressLocked();
+    // one linear pass in heap storage order, matches become tombstones,
+    // then the heap is rebuilt once.
+    for (auto msg : queue_) {
+      if (msg->cancelled) continue;
+      auto type = pred(*msg);
       if (type == RemoveMessagePredReturnType::kRemoveAndContinue ||
           type == RemoveMessagePredReturnType::kRemove) {
-        auto msg = *it;
-        it = queue_.erase(it);
-        releaseMessage(msg);
+        cancelLocked(msg);
         removed = true;
         if (type == RemoveMessagePredReturnType::kRemove) break;
-      } else {
-        ++it;
       }
     }
+    if (removed) purgeCancelledLocked();
   }
   if (removed) {
     queueNotFullCondition_.notify_all();
@@ -296,14 +508,45 @@ bool MessageQueue::removeMessageIf(
   return removed;
 }
 
-bool MessageQueue::hasDueMessageLocked() const { return !queue_.empty() && queue_.front()->due(); }
+bool MessageQueue::removeMessage(int32_t messageId) {
+  {
+    std::lock_guard<std::mutex> lk(queueMutex_);
+    drainIngressLocked();
+    auto it = messageIndex_.find(messageId);
+    if (it == messageIndex_.end()) return false;
+    cancelLocked(it->second);
+    compactLocked();
+  }
+  queueNotFullCondition_.notify_all();
+  return true;
+}
+
+bool MessageQueue::hasDueMessageLocked() {
+  auto front = frontLocked();
+  return front != nullptr && front->due();
+}
 
-size_t MessageQueue::dueMessageCount() const {
+size_t MessageQueue::dueMessageCount() {
   std::lock_guard<std::mutex> lk(queueMutex_);
+  drainIngressLocked();
   auto now = timestamp();
-  auto firstNotDue = std::find_if_not(queue_.begin(), queue_.end(),
-                                      [now](const Message* msg) { return msg->due(now); });
-  return firstNotDue - queue_.begin();
+
+  // walk the heap, subtree of a not-due message has no due message,
+  // so it costs O(due message count) rather than O(n)
+  size_t count = 0;
+  std::vector<size_t> pending;
+  if (!queue_.empty()) pending.push_back(0);
+  while (!pending.empty()) {
+    auto index = pending.back();
+    pending.pop_back();
+    auto msg = queue_[index];
+    if (!msg->due(now)) continue;
+    if (!msg->cancelled) ++count;
+    for (auto child = index * 2 + 1; child <= index * 2 + 2 && child < queue_.size(); ++child) {
+      pending.push_back(child);
+    }
+  }
+  return count;
 }
 
 bool MessageQueue::checkQuitLoopNowLocked(MessageQueue::LoopType loopType, size_t onceMessageCount,
@@ -333,7 +576,7 @@ bool MessageQueue::checkQuitLoopWhenNoDueMessageLocked(MessageQueue::LoopType lo
     return true;
   }
 
-  if (shutdown_ == ShutdownType::kAwaitQueue && queue_.empty()) {
+  if (shutdown_ == ShutdownType::kAwaitQueue && frontLocked() == nullptr) {
     // We have done await queue.
     // avoid user call loopQueue again.
     shutdown_ = ShutdownType::kNow;
@@ -343,27 +586,29 @@ bool MessageQueue::checkQuitLoopWhenNoDueMessageLocked(MessageQueue::LoopType lo
   return false;
 }
 
-Message* MessageQueue::awaitDueMessage(MessageQueue::LoopType loopType, size_t onceMessageCount,
-                                       MessageQueue::LoopReturnType& returnType) {
-  Message* dueMessage = nullptr;
+bool MessageQueue::awaitDueMessages(MessageQueue::LoopType loopType, size_t onceMessageCount,
+                                    size_t batchSize, std::vector<Message*>& dueMessages,
+                                    MessageQueue::LoopReturnType& returnType) {
   while (true) {
     std::unique_lock<std::mutex> lk(queueMutex_);
+    drainIngressLocked();
 
     if (checkQuitLoopNowLocked(loopType, onceMessageCount, returnType)) {
-      return nullptr;
+      return false;
     }
 
     if (!hasDueMessageLocked()) {
       if (checkQuitLoopWhenNoDueMessageLocked(loopType, returnType)) {
-        return nullptr;
+        return false;
       }
 
-      if (queue_.empty()) {
+      auto front = frontLocked();
+      if (front == nullptr) {
         // await for new message
         queueNotEmptyCondition_.wait(lk);
       } else {
         // await for next message due
-        auto timeToWait = queue_.front()->dueTime - timestamp();
+        auto timeToWait = front->dueTime - timestamp();
         if (timeToWait.count() > 0) {
           queueNotEmptyCondition_.wait_for(lk, timeToWait);
         }
@@ -379,17 +624,23 @@ Message* MessageQueue::awaitDueMessage(MessageQueue::LoopType loopType, size_t o
       continue;
     }
 
-    dueMessage = queue_.front();
-    queue_.pop_front();
+    auto limit = (std::max)(static_cast<size_t>(1), (std::min)(batchSize, onceMessageCount));
+    auto now = timestamp();
+    Message* front;
+    do {
+      dueMessages.push_back(queue_.front());
+      popFrontLocked();
+    } while (dueMessages.size() < limit && (front = frontLocked()) != nullptr && front->due(now));
     break;
   }
 
   queueNotFullCondition_.notify_all();
 
-  return dueMessage;
+  return true;
 }
 
-MessageQueue::LoopReturnType MessageQueue::loopQueue(MessageQueue::LoopType loopType) {
+MessageQueue::LoopReturnType MessageQueue::loopQueue(MessageQueue::LoopType loopType,
+                                                     size_t batchSize) {
   LoopQueueGuard loopQueueGuard(this);
 
   // Find out how many due message we have on loopOnce call.
@@ -402,14 +653,37 @@ MessageQueue::LoopReturnType MessageQueue::loopQueue(MessageQueue::LoopType loop
   }
   LoopReturnType returnType = LoopReturnType::kRunOnce;
 
+  std::vector<Message*> dueMessages;
   while (true) {
-    Message* message = awaitDueMessage(loopType, onceMessageCount, returnType);
-    if (message == nullptr) {
+    dueMessages.clear();
+    if (!awaitDueMessages(loopType, onceMessageCount, batchSize, dueMessages, returnType)) {
       return returnType;
     }
 
-    processMessage(message);
-    onceMessageCount--;
+    for (size_t i = 0; i < dueMessages.size(); ++i) {
+      if (i > 0 && (interrupt_ || shutdown_ == ShutdownType::kNow)) {
+        // give back the rest, then let awaitDueMessages decide how to return
+        requeueMessages(dueMessages.data() + i, dueMessages.size() - i);
+        break;
+      }
+      processMessage(dueMessages[i]);
+      onceMessageCount--;
+    }
+  }
+}
+
+void MessageQueue::requeueMessages(Message** messages, size_t count) {
+  std::lock_guard<std::mutex> lk(queueMutex_);
+  for (size_t i = 0; i < count; ++i) {
+    auto msg = messages[i];
+    if (shutdown_ == ShutdownType::kNow) {
+      releaseMessage(msg);
+      continue;
+    }
+    // keep the original sequence, so the order stays the same
+    queue_.push_back(msg);
+    siftUpLocked(queue_.size() - 1);
+    messageIndex_.emplace(msg->messageId, msg);
   }
 }
 
@@ -21,10 +21,11 @@
 #include <condition_variable>
 #include <cstddef>
 #include <cstring>
-#include <deque>
 #include <functional>
 #include <limits>
 #include <mutex>
+#include <span>
+#include <unordered_map>
 #include <vector>
 #include "../foundation.h"
 #include "MemoryPool.hpp"
@@ -67,6 +68,7 @@ inline ArbitraryData& ArbitraryData::operator=(const ArbitraryData& copy) {
 static_assert(std::is_standard_layout_v<ArbitraryData>);
 
 class InplaceMessage;
+class ThreadPool;
 
 /**
  * plain message used to post, contains only int or pointer types.
@@ -91,6 +93,14 @@ class Message : public ArbitraryData {
   MessageProc* handlerProc;
   MessageProc* cleanupProc;
 
+  // intrusive link of MessageQueue's lock-free ingress stack
+  Message* ingressNext = nullptr;
+
+  // post order, breaks ties of (dueTime, priority) so that they run FIFO
+  uint64_t sequence = 0;
+  // removed while still in MessageQueue's heap, released when reaching the top
+  bool cancelled = false;
+
  public:
   /**
    * Message priority: Messages are ordered according to due-time in the queue.
@@ -140,8 +150,10 @@ class Message : public ArbitraryData {
   bool due(std::chrono::nanoseconds now) const;
 
   friend class MessageQueue;
-  friend class MemoryPool<Message>;
+  friend class ThreadCachingMemoryPool<Message>;
   friend class InplaceMessage;
+  // work-stealing mode keeps messageId for removeMessage
+  friend class ThreadPool;
 };
 
 class InplaceMessage : public Message {
@@ -184,7 +196,7 @@ class InplaceMessage : public Message {
 
   friend class MessageQueue;
 
-  friend class MemoryPool<InplaceMessage>;
+  friend class ThreadCachingMemoryPool<InplaceMessage>;
 };
 
 // make sure we can cast InplaceMessage to Message and vice-versa.
@@ -219,38 +231,95 @@ class MessageQueue {
  private:
   enum class ShutdownType { kNone, kNow, kAwaitQueue };
 
+  static constexpr std::size_t kDefaultPoolSize = 64;
+
   std::size_t maxMessageInQueue_;
-  MemoryPool<Message> messagePool_;
-  ShutdownType shutdown_;
-  bool interrupt_;
+  // messages are obtained and released on different threads (poster and looper)
+  ThreadCachingMemoryPool<Message> messagePool_;
+  // written under queueMutex_, read without lock on ingress fast path and between batched messages
+  std::atomic<ShutdownType> shutdown_;
+  std::atomic_bool interrupt_;
+
+  // Lock-free ingress for zero-delay posts (multi-producer, LIFO linked by Message::ingressNext).
+  // Whoever holds queueMutex_ drains it into queue_ before looking at queue_,
+  // so producers of zero-delay messages never contend on queueMutex_.
+  std::atomic<Message*> ingress_;
 
   mutable std::mutex queueMutex_;
   std::condition_variable queueNotEmptyCondition_;
   std::condition_variable queueNotFullCondition_;
-  std::deque<Message*> queue_;
+
+  // Binary min-heap ordered by (dueTime, priority, sequence).
+  // Removed messages are cleaned up immediately but left in the heap as tombstones (O(1) cancel),
+  // they are dropped when reaching the top, or by compaction when they outnumber live messages.
+  std::vector<Message*> queue_;
+  std::size_t cancelledCount_;
+  // Message::sequence is taken at post time, ingress messages are enqueued later than posted
+  std::atomic_uint64_t sequenceCounter_;
+
+  using MessageIndexAllocator =
+      MemoryPool<std::pair<const int32_t, Message*>, false>::Allocator<kDefaultPoolSize, false>;
+  // messageId -> message in queue_ (excluding tombstones)
+  std::unordered_map<int32_t, Message*, std::hash<int32_t>, std::equal_to<int32_t>,
+                     MessageIndexAllocator>
+      messageIndex_;
   std::atomic_int32_t messageIdCounter_;
   std::uint32_t workerCount_;  // guard by queueMutex_
   std::condition_variable workerQuitCondition_;
 
   std::shared_ptr<Supervisor> supervisor_;
 
-  static constexpr std::size_t kDefaultPoolSize = 64;
-
   friend class Message;
 
   // used in the implementation
   friend class LoopQueueGuard;
 
+  // work-stealing mode shares message pool and processMessage
+  friend class ThreadPool;
+
  private:
   static std::chrono::nanoseconds timestamp();
 
-  bool hasDueMessageLocked() const;
+  int32_t nextMessageId();
+
+  bool hasDueMessageLocked();
+
+  static bool isBefore(const Message* lhs, const Message* rhs);
+
+  void siftUpLocked(std::size_t index);
 
-  std::deque<Message*>::const_iterator findInsertPositionLocked(std::chrono::nanoseconds dueTime,
-                                                                int32_t priority) const;
+  void siftDownLocked(std::size_t index);
+
+  /**
+   * drop tombstones on top of heap
+   * @return the first message in queue, or nullptr if empty.
+   */
+  Message* frontLocked();
+
+  void popFrontLocked();
+
+  void cancelLocked(Message* message);
+
+  // drop tombstones when they outnumber live messages
+  void compactLocked();
+
+  // drop all tombstones and rebuild the heap
+  void purgeCancelledLocked();
+
+  void clearLocked();
+
+  std::size_t messageCountLocked() const { return queue_.size() - cancelledCount_; }
 
   bool isQueueFull() const;
 
+  bool useIngress() const { return maxMessageInQueue_ == kDefaultMaxMessageInQueue; }
+
+  int32_t postToIngress(Message* message);
+
+  void drainIngressLocked();
+
+  void enqueueLocked(Message* message);
+
   void awaitNotFullLocked(std::unique_lock<std::mutex>& lock);
 
   void processMessage(Message* message);
@@ -261,7 +330,7 @@ class MessageQueue {
 
   void afterMessage(Message& message);
 
-  size_t dueMessageCount() const;
+  size_t dueMessageCount();
 
   /**
    * post a message to queue
@@ -271,6 +340,10 @@ class MessageQueue {
    */
   int32_t postMessage(Message* message, int64_t delayNanos = 0);
 
+  size_t postMessages(Message** messages, size_t count, int64_t delayNanos, int32_t* ids);
+
+  void requeueMessages(Message** messages, size_t count);
+
  public:
   static constexpr std::size_t kDefaultMaxMessageInQueue =
       // workaround windows.h "max()" marco
@@ -278,6 +351,7 @@ class MessageQueue {
 
   /**
    * @param maxMessageInQueue if call postXXX when queue is full, will block.
+   * An unbounded queue (the default) posts zero-delay messages through a lock-free ingress.
    */
   explicit MessageQueue(std::size_t maxMessageInQueue = kDefaultMaxMessageInQueue);
 
@@ -376,6 +450,39 @@ class MessageQueue {
                        std::chrono::duration_cast<std::chrono::nanoseconds>(delay).count());
   }
 
+  /**
+   * Post a batch of messages with one lock acquisition (or one atomic push for zero-delay messages
+   * on unbounded queue) and one notification. Messages in a batch share the same due-time,
+   * so they are executed in the order of priority, then the order in the span.
+   *
+   * @param ids if not empty, receives messageId of each message (0 for failure),
+   * must be at least as large as messages.
+   * @return count of messages posted, the rest is dropped because of shutdownNow()
+   */
+  template <class Rep = int64_t, class Period = std::milli>
+  size_t postMessages(std::span<const Message> messages,
+                      std::chrono::duration<Rep, Period> delay = std::chrono::milliseconds(0),
+                      std::span<int32_t> ids = {}) {
+    if (!ids.empty() && ids.size() < messages.size()) {
+      throw std::runtime_error("ids is smaller than messages");
+    }
+    constexpr size_t kStackBatch = 64;
+    Message* stack[kStackBatch];
+    std::vector<Message*> heap;
+    Message** batch = stack;
+    if (messages.size() > kStackBatch) {
+      heap.resize(messages.size());
+      batch = heap.data();
+    }
+    for (size_t i = 0; i < messages.size(); ++i) {
+      batch[i] = messagePool_.obtain();
+      *batch[i] = messages[i];
+    }
+    return postMessages(batch, messages.size(),
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(delay).count(),
+                        ids.empty() ? nullptr : ids.data());
+  }
+
   /**
    * obtain a InplaceMessage for placement new type in message.
    */
@@ -409,7 +516,19 @@ class MessageQueue {
     kShutDown,
   };
 
-  LoopReturnType loopQueue(LoopType loopType = LoopType::kLoopAndWait);
+  /**
+   * drain every due message per lock acquisition, see loopQueue
+   */
+  static constexpr std::size_t kDrainAllDue = (std::numeric_limits<std::size_t>::max)();
+
+  /**
+   * @param batchSize max count of due messages taken out of queue per lock acquisition,
+   * Supervisor is still called for each message.
+   * A message is considered dequeued once taken, thus can't be removed by removeMessage().
+   * On interrupt() or shutdownNow(), the rest of the batch is put back (or cleared) untouched.
+   * Large batch favors throughput of a single looper, but starves other loopers of the same queue.
+   */
+  LoopReturnType loopQueue(LoopType loopType = LoopType::kLoopAndWait, std::size_t batchSize = 1);
 
  private:
   bool checkQuitLoopNowLocked(MessageQueue::LoopType loopType, size_t onceMessageCount,
@@ -418,8 +537,9 @@ class MessageQueue {
   bool checkQuitLoopWhenNoDueMessageLocked(MessageQueue::LoopType loopType,
                                            MessageQueue::LoopReturnType& returnType);
 
-  Message* awaitDueMessage(MessageQueue::LoopType loopType, size_t onceMessageCount,
-                           MessageQueue::LoopReturnType& returnType);
+  bool awaitDueMessages(MessageQueue::LoopType loopType, size_t onceMessageCount,
+                        size_t batchSize, std::vector<Message*>& dueMessages,
+                        MessageQueue::LoopReturnType& returnType);
 
  public:
   // removeMessage family
@@ -430,6 +550,7 @@ class MessageQueue {
     kDontRemove,
     /**
      * remove this message, and don't search for any message.
+     * messages are visited in queue storage order, not necessarily in execution order.
      */
     kRemove,
     /**
@@ -440,12 +561,11 @@ class MessageQueue {
 
   bool removeMessageIf(const std::function<RemoveMessagePredReturnType(Message&)>& pred);
 
-  bool removeMessage(int32_t messageId) {
-    return removeMessageIf([messageId](const Message& msg) {
-      return msg.messageId == messageId ? RemoveMessagePredReturnType::kRemove
-                                        : RemoveMessagePredReturnType::kDontRemove;
-    });
-  }
+  /**
+   * O(1) lookup by id.
+   * @return removed or not
+   */
+  bool removeMessage(int32_t messageId);
 
   /**
    * @param what Message::what
@@ -16,11 +16,49 @@
  */
 
 #include "ThreadPool.h"
+#include <algorithm>
+#include <deque>
+#include "ThreadLocal.h"
 
 namespace script::utils {
 
+struct ThreadPool::StealingWorker {
+  std::mutex lock;
+  // posted from this worker, popped LIFO by owner
+  std::deque<Message*> local;
+  // posted from other threads, popped FIFO
+  std::deque<Message*> inbox;
+};
+
+namespace {
+
+struct CurrentStealingWorker {
+  ThreadPool* pool = nullptr;
+  size_t index = 0;
+};
+
+// how many rounds an idle worker looks for work before park
+constexpr size_t kStealingSpinCount = 64;
+
+}  // namespace
+
+SCRIPTX_THREAD_LOCAL(CurrentStealingWorker, currentStealingWorker_);
+
+static inline CurrentStealingWorker& getCurrentStealingWorker() {
+  return internal::getThreadLocal(currentStealingWorker_);
+}
+
 ThreadPool::ThreadPool(size_t workerThreads, std::unique_ptr<MessageQueue>&& queue)
-    : queue_(std::move(queue)), workers_(workerThreads), threadMutex_() {
+    : mode_(Mode::kSharedQueue),
+      queue_(std::move(queue)),
+      workers_(workerThreads),
+      threadMutex_(),
+      state_(State::kRunning),
+      timerDone_(false),
+      queuedMessages_(0),
+      activeMessages_(0),
+      nextWorker_(0),
+      parkedWorkers_(0) {
   std::lock_guard<std::mutex> lg(threadMutex_);
 
   if (!queue_) {
@@ -35,13 +73,60 @@ ThreadPool::ThreadPool(size_t workerThreads, std::unique_ptr<MessageQueue>&& que
   }
 }
 
+ThreadPool::ThreadPool(size_t workerThreads, Mode mode)
+    : ThreadPool(mode == Mode::kSharedQueue ? workerThreads : 0) {
+  if (mode == Mode::kSharedQueue) return;
+
+  std::lock_guard<std::mutex> lg(threadMutex_);
+  mode_ = mode;
+  if (workerThreads == 0) workerThreads = 1;
+
+  stealingWorkers_.resize(workerThreads);
+  for (auto& w : stealingWorkers_) {
+    w = std::make_unique<StealingWorker>();
+  }
+
+  workers_.resize(workerThreads);
+  for (size_t i = 0; i < workerThreads; ++i) {
+    workers_[i] = std::make_unique<std::thread>([this, i]() { stealingWorkerLoop(i); });
+  }
+
+  timerThread_ = std::make_unique<std::thread>([this]() {
+    while (queue_->loopQueue() != MessageQueue::LoopReturnType::kShutDown) {
+    }
+    {
+      std::lock_guard<std::mutex> lk(parkMutex_);
+      timerDone_ = true;
+    }
+    parkCondition_.notify_all();
+  });
+}
+
 ThreadPool::~ThreadPool() { shutdownNow(true); }
 
 size_t ThreadPool::workerCount() { return workers_.size(); }
 
-void ThreadPool::removeMessage(int32_t id) { queue_->removeMessage(id); }
+void ThreadPool::removeMessage(int32_t id) {
+  if (queue_->removeMessage(id) || mode_ != Mode::kWorkStealing) return;
+  removeStealing(id);
+}
 
 void ThreadPool::shutdown(bool awaitTermination) {
+  if (mode_ == Mode::kWorkStealing) {
+    {
+      std::lock_guard<std::mutex> lk(parkMutex_);
+      auto running = State::kRunning;
+      state_.compare_exchange_strong(running, State::kAwaitQueue);
+    }
+    // timer thread quits once all delayed messages are handed over
+    queue_->shutdown(false);
+    parkCondition_.notify_all();
+    if (awaitTermination) {
+      joinWorkers();
+    }
+    return;
+  }
+
   queue_->shutdown(awaitTermination);
   if (awaitTermination) {
     joinWorkers();
@@ -49,6 +134,20 @@ void ThreadPool::shutdown(bool awaitTermination) {
 }
 
 void ThreadPool::shutdownNow(bool awaitTermination) {
+  if (mode_ == Mode::kWorkStealing) {
+    {
+      std::lock_guard<std::mutex> lk(parkMutex_);
+      state_ = State::kNow;
+    }
+    queue_->shutdownNow(false);
+    parkCondition_.notify_all();
+    releaseStealing();
+    if (awaitTermination) {
+      joinWorkers();
+    }
+    return;
+  }
+
   queue_->shutdownNow(awaitTermination);
   if (awaitTermination) {
     joinWorkers();
@@ -56,7 +155,9 @@ void ThreadPool::shutdownNow(bool awaitTermination) {
 }
 
 void ThreadPool::awaitTermination() {
-  queue_->awaitTermination();
+  if (mode_ == Mode::kSharedQueue) {
+    queue_->awaitTermination();
+  }
   joinWorkers();
 }
 
@@ -67,6 +168,184 @@ void ThreadPool::joinWorkers() {
       w->join();
     }
   }
+  if (timerThread_ && timerThread_->joinable()) {
+    timerThread_->join();
+  }
+}
+
+int32_t ThreadPool::postStealing(Message* message, int64_t delayNanos) {
+  if (delayNanos > 0) {
+    // hand over to workers when due, until then it can be removed by id from queue_
+    Message timer(
+        [](Message& self) {
+          auto message = static_cast<Message*>(self.ptr1);
+          self.ptr1 = nullptr;
+          static_cast<ThreadPool*>(self.ptr0)->submitStealing(message);
+        },
+        [](Message& self) {
+          if (auto message = static_cast<Message*>(self.ptr1)) {
+            static_cast<ThreadPool*>(self.ptr0)->queue_->releaseMessage(message);
+          }
+        });
+    timer.ptr0 = this;
+    timer.ptr1 = message;
+    return queue_->postMessage(timer, std::chrono::nanoseconds(delayNanos));
+  }
+
+  if (state_ == State::kNow) {
+    queue_->releaseMessage(message);
+    return 0;
+  }
+  // the message carries its id, so removeMessage can find it in the worker deques
+  auto id = queue_->nextMessageId();
+  message->messageId = id;
+  submitStealing(message);
+  return id;
+}
+
+void ThreadPool::submitStealing(Message* message) {
+  ++activeMessages_;
+  ++queuedMessages_;
+
+  auto& current = getCurrentStealingWorker();
+  if (current.pool == this) {
+    auto& worker = *stealingWorkers_[current.index];
+    std::lock_guard<std::mutex> lk(worker.lock);
+    worker.local.push_back(message);
+  } else {
+    auto& worker = *stealingWorkers_[nextWorker_++ % stealingWorkers_.size()];
+    std::lock_guard<std::mutex> lk(worker.lock);
+    worker.inbox.push_back(message);
+  }
+
+  // a parking worker increases parkedWorkers_ before checking queuedMessages_,
+  // so either it sees the message, or we see it parking.
+  if (parkedWorkers_ > 0) {
+    { std::lock_guard<std::mutex> lk(parkMutex_); }
+    parkCondition_.notify_one();
+  }
+
+  if (state_ == State::kNow) {
+    // raced with shutdownNow
+    releaseStealing();
+  }
+}
+
+Message* ThreadPool::takeStealing(size_t index) {
+  {
+    auto& self = *stealingWorkers_[index];
+    std::lock_guard<std::mutex> lk(self.lock);
+    if (!self.local.empty()) {
+      auto message = self.local.back();
+      self.local.pop_back();
+      return message;
+    }
+    if (!self.inbox.empty()) {
+      auto message = self.inbox.front();
+      self.inbox.pop_front();
+      return message;
+    }
+  }
+
+  // steal the oldest one from others
+  auto count = stealingWorkers_.size();
+  for (size_t i = 1; i < count; ++i) {
+    auto& victim = *stealingWorkers_[(index + i) % count];
+    std::unique_lock<std::mutex> lk(victim.lock, std::try_to_lock);
+    if (!lk.owns_lock()) continue;
+    for (auto queue : {&victim.inbox, &victim.local}) {
+      if (!queue->empty()) {
+        auto message = queue->front();
+        queue->pop_front();
+        return message;
+      }
+    }
+  }
+  return nullptr;
+}
+
+void ThreadPool::releaseStealing() {
+  for (auto& w : stealingWorkers_) {
+    std::lock_guard<std::mutex> lk(w->lock);
+    for (auto queue : {&w->local, &w->inbox}) {
+      for (auto message : *queue) {
+        queue_->releaseMessage(message);
+        --queuedMessages_;
+        --activeMessages_;
+      }
+      queue->clear();
+    }
+  }
+}
+
+bool ThreadPool::removeStealing(int32_t id) {
+  for (auto& w : stealingWorkers_) {
+    Message* message = nullptr;
+    {
+      std::lock_guard<std::mutex> lk(w->lock);
+      for (auto queue : {&w->local, &w->inbox}) {
+        auto it = std::find_if(queue->begin(), queue->end(),
+                               [id](Message* m) { return m->messageId == id; });
+        if (it != queue->end()) {
+          message = *it;
+          queue->erase(it);
+          break;
+        }
+      }
+    }
+    if (message) {
+      queue_->releaseMessage(message);
+      --queuedMessages_;
+      if (--activeMessages_ == 0 && state_ != State::kRunning) {
+        wakeUpAll();
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ThreadPool::shouldQuitLocked() {
+  if (state_ == State::kAwaitQueue && timerDone_ && activeMessages_ == 0) {
+    // We have done await queue, post after this fails.
+    state_ = State::kNow;
+  }
+  return state_ == State::kNow;
+}
+
+void ThreadPool::wakeUpAll() {
+  { std::lock_guard<std::mutex> lk(parkMutex_); }
+  parkCondition_.notify_all();
+}
+
+void ThreadPool::stealingWorkerLoop(size_t index) {
+  getCurrentStealingWorker() = {this, index};
+
+  size_t idleRounds = 0;
+  while (state_ != State::kNow) {
+    if (auto message = takeStealing(index)) {
+      --queuedMessages_;
+      queue_->processMessage(message);
+      if (--activeMessages_ == 0 && state_ != State::kRunning) {
+        wakeUpAll();
+      }
+      idleRounds = 0;
+      continue;
+    }
+
+    if (++idleRounds < kStealingSpinCount) {
+      std::this_thread::yield();
+      continue;
+    }
+    idleRounds = 0;
+
+    std::unique_lock<std::mutex> lk(parkMutex_);
+    ++parkedWorkers_;
+    parkCondition_.wait(lk, [this]() { return queuedMessages_ > 0 || shouldQuitLocked(); });
+    --parkedWorkers_;
+  }
+
+  getCurrentStealingWorker() = {};
 }
 
-}  // namespace script::utils
\ No newline at end of file
+}  // namespace script::utils
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <condition_variable>
 #include <thread>
 #include "MessageQueue.h"
 
@@ -26,10 +27,49 @@ namespace script::utils {
  * A fixed thread-pool based on MessageQueue.
  */
 class ThreadPool {
+ public:
+  enum class Mode {
+    /**
+     * all workers loop on one shared MessageQueue.
+     */
+    kSharedQueue,
+    /**
+     * Each worker owns a deque, messages posted from a worker are pushed to its own deque and
+     * popped LIFO, messages posted from other threads are distributed round-robin and run FIFO.
+     * Idle workers steal the oldest message from others, spin for a while then park.
+     * Delayed messages are scheduled by an extra timer thread looping the MessageQueue,
+     * and handed over to workers when due.
+     *
+     * note: removeMessage only works for messages which are not taken by a worker yet.
+     * Owner push/pop on its deque still takes the (uncontended) per-worker mutex.
+     */
+    kWorkStealing,
+  };
+
+ private:
+  enum class State { kRunning, kAwaitQueue, kNow };
+
+  struct StealingWorker;
+
+  Mode mode_;
   std::unique_ptr<MessageQueue> queue_;
   std::vector<std::unique_ptr<std::thread>> workers_;
   std::mutex threadMutex_;
 
+  // work-stealing mode
+  std::vector<std::unique_ptr<StealingWorker>> stealingWorkers_;
+  std::unique_ptr<std::thread> timerThread_;
+  std::atomic<State> state_;
+  bool timerDone_;  // guard by parkMutex_
+  // posted but not taken by any worker
+  std::atomic_int64_t queuedMessages_;
+  // posted but not finished
+  std::atomic_int64_t activeMessages_;
+  std::atomic_size_t nextWorker_;
+  std::atomic_size_t parkedWorkers_;
+  std::mutex parkMutex_;
+  std::condition_variable parkCondition_;
+
  public:
   /**
    * @param workerThreads concurrency, default is 1
@@ -39,15 +79,28 @@ class ThreadPool {
    */
   explicit ThreadPool(size_t workerThreads = 1, std::unique_ptr<MessageQueue>&& queue = {});
 
+  /**
+   * @param workerThreads concurrency
+   * @param mode see ThreadPool::Mode
+   */
+  ThreadPool(size_t workerThreads, Mode mode);
+
   ~ThreadPool();
 
   SCRIPTX_DISALLOW_COPY_AND_MOVE(ThreadPool);
 
   size_t workerCount();
 
+  Mode mode() const { return mode_; }
+
   template <class Rep = int, class Period = std::milli>
   int32_t postMessage(const Message& message,
                       std::chrono::duration<Rep, Period> delay = std::chrono::milliseconds(0)) {
+    if (mode_ == Mode::kWorkStealing) {
+      auto m = queue_->messagePool_.obtain();
+      *m = message;
+      return postStealing(m, std::chrono::duration_cast<std::chrono::nanoseconds>(delay).count());
+    }
     return queue_->postMessage(message, delay);
   }
 
@@ -65,6 +118,13 @@ class ThreadPool {
   template <class Rep = int, class Period = std::milli>
   int32_t postMessage(std::unique_ptr<InplaceMessage>& message,
                       std::chrono::duration<Rep, Period> delay = std::chrono::milliseconds(0)) {
+    if (mode_ == Mode::kWorkStealing) {
+      if (!message->getCleanupProc()) {
+        throw std::runtime_error("InplaceMessage haven't placed anything");
+      }
+      return postStealing(message.release(),
+                          std::chrono::duration_cast<std::chrono::nanoseconds>(delay).count());
+    }
     return queue_->postMessage(message, delay);
   }
 
@@ -78,6 +138,29 @@ class ThreadPool {
 
  private:
   void joinWorkers();
+
+  /**
+   * take the ownership of message
+   */
+  int32_t postStealing(Message* message, int64_t delayNanos);
+
+  void submitStealing(Message* message);
+
+  Message* takeStealing(size_t index);
+
+  void releaseStealing();
+
+  /**
+   * remove a zero-delay message not taken by any worker yet.
+   * @return removed or not
+   */
+  bool removeStealing(int32_t id);
+
+  void stealingWorkerLoop(size_t index);
+
+  bool shouldQuitLocked();
+
+  void wakeUpAll();
 };
 
 }  // namespace script::utils
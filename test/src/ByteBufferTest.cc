@@ -15,6 +15,7 @@
  * limitations under the License.
  */
 
+#include <vector>
 #include "test.h"
 
 namespace script::test {
@@ -218,6 +219,105 @@ return testBuffer:readInt8(5) == 2 and testBuffer:readInt8(6) == 0 and testBuffe
 #endif
 }
 
+#ifndef SCRIPTX_BACKEND_WEBASSEMBLY
+
+TEST_F(ByteBufferTest, CreateSharedNoCopy) {
+  constexpr size_t kSize = 1024 * 1024;
+  std::vector<uint8_t> frame(kSize, 0);
+  auto released = std::make_shared<bool>(false);
+
+  {
+    EngineScope engineScope(engine);
+    // wrap caller's memory, the deleter acts as release callback
+    auto buffer = ByteBuffer::newByteBuffer(
+        std::shared_ptr<void>(frame.data(), [released](void*) { *released = true; }), kSize);
+    EXPECT_EQ(buffer.getRawBytes(), frame.data());
+    EXPECT_EQ(buffer.getRawBytesShared().get(), frame.data());
+    EXPECT_EQ(buffer.byteLength(), kSize);
+
+    engine->set("testBuffer", buffer);
+    auto ret = engine->eval(TS().js("testBuffer").lua("return testBuffer").select());
+    ASSERT_TRUE(ret.isByteBuffer());
+    EXPECT_EQ(ret.asByteBuffer().getRawBytes(), frame.data());
+    EXPECT_FALSE(*released);
+
+    // the copy path always has its own storage
+    auto copy = ByteBuffer::newByteBuffer(static_cast<void*>(frame.data()), kSize);
+    EXPECT_NE(copy.getRawBytes(), frame.data());
+    engine->set("testBuffer", Local<Value>());
+  }
+
+#ifdef SCRIPTX_BACKEND_HERMES
+  // backing store is dropped with the runtime at last
+  destroyEngine();
+  EXPECT_TRUE(*released);
+#endif
+}
+
+TEST_F(ByteBufferTest, PassThroughBenchmark) {
+  SKIP_UNLESS_BENCHMARK_ENABLED();
+
+  constexpr size_t kSize = 16 * 1024 * 1024;
+  constexpr int kRound = 100;
+  auto frame = std::shared_ptr<uint8_t>(new uint8_t[kSize](), std::default_delete<uint8_t[]>());
+
+  EngineScope engineScope(engine);
+  auto passThrough = engine
+                         ->eval(TS().js("(function (b) { return b; })")
+                                    .lua("return function (b) return b end")
+                                    .select())
+                         .asFunction();
+
+  auto run = [&](const char* name, auto&& create) {
+    runBenchmark(name, kRound, [&]() {
+      for (int i = 0; i < kRound; ++i) {
+        StackFrameScope stack;
+        auto ret = passThrough.call({}, create());
+        ASSERT_TRUE(ret.isByteBuffer());
+      }
+    });
+  };
+
+  run("copy", [&]() { return ByteBuffer::newByteBuffer(static_cast<void*>(frame.get()), kSize); });
+  run("shared", [&]() { return ByteBuffer::newByteBuffer(frame, kSize); });
+}
+
+#endif
+
+TEST_F(ByteBufferTest, Span) {
+  EngineScope engineScope(engine);
+  auto buffer = ByteBuffer::newByteBuffer(16);
+
+  auto floats = buffer.asSpan<float>();
+  ASSERT_EQ(floats.size(), 4);
+  for (size_t i = 0; i < floats.size(); ++i) {
+    floats[i] = static_cast<float>(i) + 0.5f;
+  }
+  buffer.commit();
+  EXPECT_EQ(buffer.asSpan<uint8_t>().size(), 16);
+
+  float out[2];
+  buffer.copyTo(out, sizeof(out), sizeof(float) * 2);
+  EXPECT_FLOAT_EQ(out[0], 2.5f);
+  EXPECT_FLOAT_EQ(out[1], 3.5f);
+
+  const int32_t in[] = {1, 2};
+  buffer.copyFrom(in, sizeof(in));
+  EXPECT_EQ(buffer.asSpan<int32_t>()[1], 2);
+
+  EXPECT_THROW(buffer.copyFrom(in, sizeof(in), 12), Exception);
+  EXPECT_THROW(buffer.copyTo(out, sizeof(out), 20), Exception);
+  EXPECT_THROW(ByteBuffer::newByteBuffer(6).asSpan<int32_t>(), Exception);
+
+#if defined(SCRIPTX_LANG_JAVASCRIPT) && !defined(SCRIPTX_BACKEND_WEBASSEMBLY)
+  auto typed = engine->eval("new Float32Array([1, 2, 3])").asByteBuffer();
+  auto span = typed.asSpan<float>();
+  ASSERT_EQ(span.size(), 3);
+  EXPECT_FLOAT_EQ(span[2], 3);
+  EXPECT_THROW(typed.asSpan<int32_t>(), Exception);
+#endif
+}
+
 TEST_F(ByteBufferTest, IsInstance) {
   EngineScope engineScope(engine);
   auto buffer = ByteBuffer::newByteBuffer(8);
@@ -375,6 +475,80 @@ view;
   }
 }
 
+TEST_F(ByteBufferTest, NotByteBuffer) {
+  EngineScope engineScope(engine);
+  for (auto code : {"({byteLength: 8, buffer: {}})", "[1, 2, 3]", "(function() {})", "'str'"}) {
+    auto ret = engine->eval(code);
+    EXPECT_FALSE(ret.isByteBuffer()) << code;
+  }
+  auto view = engine->eval("new Uint8ClampedArray(4)");
+  ASSERT_TRUE(view.isByteBuffer());
+  EXPECT_EQ(view.asByteBuffer().getType(), ByteBuffer::Type::kUint8);
+}
+
+TEST_F(ByteBufferTest, OffsetView) {
+  EngineScope engineScope(engine);
+  try {
+    auto ret = engine->eval(R"(
+(function() {
+  const buf = new ArrayBuffer(16);
+  const bytes = new Uint8Array(buf);
+  for (let i = 0; i < 16; ++i) bytes[i] = i;
+  return [buf, new Uint8Array(buf, 4, 8), new DataView(buf, 2, 6)];
+})();
+)")
+                   .asArray();
+
+    auto base = static_cast<uint8_t*>(ret.get(0).asByteBuffer().getRawBytes());
+    ASSERT_NE(base, nullptr);
+
+    auto u8 = ret.get(1).asByteBuffer();
+    EXPECT_EQ(u8.getType(), ByteBuffer::Type::kUint8);
+    EXPECT_EQ(u8.byteLength(), 8);
+    auto u8Bytes = static_cast<uint8_t*>(u8.getRawBytes());
+    EXPECT_EQ(u8Bytes, base + 4);
+    EXPECT_EQ(u8Bytes[0], 4);
+    EXPECT_EQ(u8Bytes[7], 11);
+
+    auto dataView = ret.get(2).asByteBuffer();
+    EXPECT_EQ(dataView.getType(), ByteBuffer::Type::kUnspecified);
+    EXPECT_EQ(dataView.byteLength(), 6);
+    auto dataViewBytes = static_cast<uint8_t*>(dataView.getRawBytes());
+    EXPECT_EQ(dataViewBytes, base + 2);
+    EXPECT_EQ(dataViewBytes[0], 2);
+    EXPECT_EQ(dataViewBytes[5], 7);
+  } catch (const Exception& e) {
+    FAIL() << e;
+  }
+}
+
+TEST_F(ByteBufferTest, AccessorBenchmark) {
+  SKIP_UNLESS_BENCHMARK_ENABLED();
+
+  constexpr int kRound = 1000000;
+  EngineScope engineScope(engine);
+  auto view = engine->eval("new Float32Array(256)");
+  auto object = engine->eval("({})");
+
+  auto run = [&](const char* name, auto&& access) {
+    runBenchmark(name, kRound, [&]() {
+      for (int i = 0; i < kRound; ++i) {
+        StackFrameScope stack;
+        access();
+      }
+    });
+  };
+
+  run("isByteBuffer", [&]() { view.isByteBuffer(); });
+  run("isByteBuffer(no)", [&]() { object.isByteBuffer(); });
+  run("getRawBytes", [&]() {
+    auto buffer = view.asByteBuffer();
+    buffer.getType();
+    buffer.getRawBytes();
+  });
+  run("operator==", [&]() { (void)(view == object); });
+}
+
 #elif defined(SCRIPTX_LANG_LUA)
 
 TEST_F(ByteBufferTest, Variants) {
@@ -396,5 +570,45 @@ buffer:writeFloat(5, 3.14);
   engine->set("buffer", {});
 }
 
+TEST_F(ByteBufferTest, LuaBulkAccess) {
+  EngineScope engineScope(engine);
+  auto buffer = ByteBuffer::newByteBuffer(16);
+  engine->set("buffer", buffer);
+  auto bytes = static_cast<uint8_t*>(buffer.getRawBytes());
+
+  engine->eval(R"(
+buffer:fill(0)
+buffer:writeInt32Array(1, {1, 2, 3})
+)");
+  EXPECT_EQ(buffer.asSpan<int32_t>()[2], 3);
+  EXPECT_EQ(buffer.asSpan<int32_t>()[3], 0);
+
+  auto ret = engine->eval(R"(
+local t = buffer:readInt32Array(5, 2)
+return #t * 100 + t[1] * 10 + t[2]
+)");
+  EXPECT_EQ(ret.asNumber().toInt32(), 223);
+
+  engine->eval(R"(
+buffer:writeString("abc", 13)
+buffer:copy(buffer, 1, 13, 3)
+)");
+  EXPECT_EQ(std::string(reinterpret_cast<char*>(bytes), 3), "abc");
+  ret = engine->eval("return buffer:readString(1, 3) .. buffer:size()");
+  EXPECT_EQ(ret.asString().toString(), "abc16");
+
+  ret = engine->eval(R"(
+local view = buffer:bytes()
+view[16] = 255
+return #view + view[1] + (view[17] == nil and 1 or 0)
+)");
+  EXPECT_EQ(ret.asNumber().toInt32(), 16 + 'a' + 1);
+  EXPECT_EQ(bytes[15], 255);
+
+  EXPECT_THROW(engine->eval("buffer:readInt32Array(15, 1)"), Exception);
+  EXPECT_THROW(engine->eval("buffer:bytes()[0] = 1"), Exception);
+  engine->set("buffer", {});
+}
+
 #endif
 }  // namespace script::test
\ No newline at end of file
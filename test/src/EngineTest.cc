@@ -15,6 +15,7 @@
  * limitations under the License.
  */
 
+#include <sstream>
 #include "test.h"
 
 namespace script::test {
@@ -41,6 +42,33 @@ TEST_F(EngineTest, Misc) {
 #endif
 }
 
+TEST_F(EngineTest, HeapStatistics) {
+  EngineScope engineScope(engine);
+  engine->eval(TS().js("var heapStatisticsData = [1, 2, 3];")
+                   .lua("heapStatisticsData = {1, 2, 3}")
+                   .select());
+
+  [[maybe_unused]] auto statistics = engine->getHeapStatistics();
+#if defined(SCRIPTX_BACKEND_HERMES) || defined(SCRIPTX_BACKEND_V8) || \
+    defined(SCRIPTX_BACKEND_LUA) || defined(SCRIPTX_BACKEND_QUICKJS)
+  EXPECT_GT(statistics.usedHeapSize, 0);
+  EXPECT_GT(statistics.totalHeapSize, 0);
+#endif
+}
+
+#ifdef SCRIPTX_LANG_JAVASCRIPT
+TEST_F(EngineTest, GlobalGetSetUtf8Key) {
+  EngineScope engineScope(engine);
+  auto key = String::newString(u8"全局变量");
+  engine->set(key, Number::newNumber(42));
+  EXPECT_EQ(engine->get(key).asNumber().toInt32(), 42);
+  EXPECT_EQ(engine->eval(u8"全局变量 + 1").asNumber().toInt32(), 43);
+
+  engine->eval(u8"全局变量 = 'changed';");
+  EXPECT_EQ(engine->get(key).asString().toString(), "changed");
+}
+#endif
+
 TEST_F(EngineTest, UserData) {
   EXPECT_TRUE(engine->getData() == nullptr);
   auto data = std::make_shared<bool>(false);
@@ -131,6 +159,50 @@ TEST_F(EngineTest, LuaBuiltIns) {
   }
 }
 
+TEST_F(EngineTest, LuaHeapLimit) {
+  bool nearLimit = false;
+  EngineOptions options;
+  options.maxHeapSize = 4 * 1024 * 1024;
+  options.nearHeapLimitCallback = [&nearLimit](ScriptEngine*) { nearLimit = true; };
+
+  auto lua = new lua_backend::LuaEngine({}, {}, {}, options);
+  {
+    EngineScope engineScope(lua);
+    EXPECT_EQ(lua->eval("return 1 + 1").asNumber().toInt32(), 2);
+    EXPECT_FALSE(nearLimit);
+
+    EXPECT_THROW(lua->eval(R"(
+      local t = {}
+      for i = 1, 1e9 do t[i] = string.rep("x", 1024) .. i end
+    )"),
+                 Exception);
+    EXPECT_TRUE(nearLimit);
+
+    auto statistics = lua->getHeapStatistics();
+    EXPECT_EQ(statistics.heapSizeLimit, options.maxHeapSize);
+    EXPECT_LE(statistics.usedHeapSize, options.maxHeapSize);
+
+    // still usable once the garbage is collected
+    lua->gc();
+    EXPECT_EQ(lua->eval("return 1 + 1").asNumber().toInt32(), 2);
+  }
+  lua->destroy();
+}
+
+TEST_F(EngineTest, LuaGcThreshold) {
+  EngineOptions options;
+  // far beyond the initialized heap, the pause is clamped to its maximum
+  options.gcThreshold = 1024 * 1024 * 1024;
+
+  auto lua = new lua_backend::LuaEngine({}, {}, {}, options);
+  {
+    EngineScope engineScope(lua);
+    // setpause returns the previous pause
+    EXPECT_EQ(lua->eval("return collectgarbage('setpause', 200)").asNumber().toInt32(), 1000);
+  }
+  lua->destroy();
+}
+
 #endif
 
 #ifdef SCRIPTX_LANG_JAVASCRIPT
@@ -187,4 +259,295 @@ TEST_F(EngineTest, JsPromiseTest2) {
 }
 #endif
 
+#ifdef SCRIPTX_BACKEND_QUICKJS
+TEST_F(EngineTest, QjsCodeCache) {
+  auto store = std::make_shared<utils::LruCodeCacheStore>();
+  const std::string source = "(function (a, b) { return a * b; })(6, 7);";
+
+  auto qjs = static_cast<qjs_backend::QjsEngine*>(engine);
+  qjs->setCodeCacheStore(store);
+  {
+    EngineScope engineScope(engine);
+    EXPECT_EQ(engine->evalInPlace(source).asNumber().toInt32(), 42);
+    EXPECT_EQ(qjs->codeCacheMissCount(), 1);
+    EXPECT_EQ(qjs->codeCacheHitCount(), 0);
+    EXPECT_EQ(store->size(), 1);
+
+    EXPECT_EQ(engine->evalInPlace(source).asNumber().toInt32(), 42);
+    EXPECT_EQ(qjs->codeCacheMissCount(), 1);
+    EXPECT_EQ(qjs->codeCacheHitCount(), 1);
+
+    // syntax error is never cached
+    EXPECT_THROW(engine->evalInPlace(std::string("1 +")), Exception);
+    EXPECT_EQ(store->size(), 1);
+  }
+
+  // another engine loads bytecode from the shared store
+  auto other = new qjs_backend::QjsEngine();
+  other->setCodeCacheStore(store);
+  {
+    EngineScope engineScope(other);
+    EXPECT_EQ(other->evalInPlace(source).asNumber().toInt32(), 42);
+    EXPECT_EQ(other->codeCacheMissCount(), 0);
+    EXPECT_EQ(other->codeCacheHitCount(), 1);
+  }
+  other->destroy();
+}
+
+TEST_F(EngineTest, QjsCodeCacheVerifiesEntry) {
+  auto store = std::make_shared<utils::LruCodeCacheStore>();
+  const std::string source = "6 * 7;";
+  const std::string otherSource = "6 * 8;";
+  const auto otherKey = utils::CodeCacheStore::hash(otherSource, "<unknown>");
+
+  auto qjs = static_cast<qjs_backend::QjsEngine*>(engine);
+  qjs->setCodeCacheStore(store);
+  EngineScope engineScope(engine);
+  EXPECT_EQ(engine->evalInPlace(source).asNumber().toInt32(), 42);
+
+  // simulate a hash collision: the entry of source is found under the key of otherSource
+  store->put(otherKey, store->get(utils::CodeCacheStore::hash(source, "<unknown>")));
+  EXPECT_EQ(engine->evalInPlace(otherSource).asNumber().toInt32(), 48);
+  EXPECT_EQ(qjs->codeCacheHitCount(), 0);
+  EXPECT_EQ(qjs->codeCacheMissCount(), 2);
+
+  // the entry was replaced by the right one
+  EXPECT_EQ(engine->evalInPlace(otherSource).asNumber().toInt32(), 48);
+  EXPECT_EQ(qjs->codeCacheHitCount(), 1);
+
+  // data not written by this QuickJs build, ie. from a store shared across versions
+  store->put(otherKey, std::make_shared<std::vector<uint8_t>>(64, uint8_t{0x5a}));
+  EXPECT_EQ(engine->evalInPlace(otherSource).asNumber().toInt32(), 48);
+  EXPECT_EQ(qjs->codeCacheHitCount(), 1);
+  EXPECT_EQ(qjs->codeCacheMissCount(), 3);
+}
+
+TEST_F(EngineTest, QjsHeapLimit) {
+  bool nearLimit = false;
+  EngineOptions options;
+  options.maxHeapSize = 8 * 1024 * 1024;
+  options.gcThreshold = 1024 * 1024;
+  options.nearHeapLimitCallback = [&nearLimit](ScriptEngine*) { nearLimit = true; };
+
+  auto qjs = new qjs_backend::QjsEngine(nullptr, nullptr, options);
+  {
+    EngineScope engineScope(qjs);
+    EXPECT_EQ(qjs->eval("1 + 1").asNumber().toInt32(), 2);
+    EXPECT_FALSE(nearLimit);
+
+    EXPECT_THROW(qjs->eval("var a = []; while (true) a.push('x'.repeat(1024) + a.length);"),
+                 Exception);
+    EXPECT_TRUE(nearLimit);
+
+    auto statistics = qjs->getHeapStatistics();
+    EXPECT_EQ(statistics.heapSizeLimit, options.maxHeapSize);
+    EXPECT_LE(statistics.totalHeapSize, options.maxHeapSize);
+
+    // usable again once the garbage is collected
+    qjs->eval("a = undefined;");
+    qjs->gc();
+    EXPECT_EQ(qjs->eval("1 + 1").asNumber().toInt32(), 2);
+  }
+  qjs->destroy();
+}
+#endif
+
+#ifdef SCRIPTX_BACKEND_HERMES
+TEST_F(EngineTest, HermesPreparedScript) {
+  const std::string source = "(function (a, b) { return a * b; })(6, 7);";
+
+  auto hermes = static_cast<hermes_backend::HermesEngine*>(engine);
+  hermes_backend::HermesEngine::PreparedScript prepared;
+  {
+    EngineScope engineScope(engine);
+    prepared = hermes->prepare(source, "prepared.js");
+    ASSERT_TRUE(prepared != nullptr);
+    EXPECT_EQ(hermes->evaluatePrepared(prepared).asNumber().toInt32(), 42);
+    EXPECT_EQ(hermes->evaluatePrepared(prepared).asNumber().toInt32(), 42);
+    EXPECT_EQ(hermes->prepare(source, "prepared.js"), prepared);
+    EXPECT_NE(hermes->prepare(source, "other.js"), prepared);
+
+    EXPECT_THROW(hermes->prepare(std::string("1 +")), Exception);
+    EXPECT_THROW(hermes->evaluatePrepared({}), Exception);
+  }
+
+  // another engine shares the prepared script
+  auto other = new hermes_backend::HermesEngine();
+  {
+    EngineScope engineScope(other);
+    EXPECT_EQ(other->prepare(source, "prepared.js"), prepared);
+    EXPECT_EQ(other->evaluatePrepared(prepared).asNumber().toInt32(), 42);
+  }
+  other->destroy();
+
+  hermes_backend::HermesEngine::clearPreparedCache();
+  {
+    EngineScope engineScope(engine);
+    EXPECT_NE(hermes->prepare(source, "prepared.js"), prepared);
+    EXPECT_EQ(hermes->evaluatePrepared(prepared).asNumber().toInt32(), 42);
+  }
+  hermes_backend::HermesEngine::clearPreparedCache();
+}
+
+TEST_F(EngineTest, HermesPreparedScriptEviction) {
+  const std::string first = "(function () { return 1; })();";
+  const std::string second = "(function () { return 2; })();";
+
+  auto hermes = static_cast<hermes_backend::HermesEngine*>(engine);
+  EngineScope engineScope(engine);
+  hermes_backend::HermesEngine::clearPreparedCache();
+  // room for one of them only, each is charged for its source and the bytecode compiled from it
+  hermes_backend::HermesEngine::setPreparedCacheMaxBytes(2 * (first.size() + second.size()) - 1);
+
+  auto preparedFirst = hermes->prepare(first);
+  EXPECT_EQ(hermes->prepare(first), preparedFirst);
+  auto preparedSecond = hermes->prepare(second);
+  EXPECT_EQ(hermes->prepare(second), preparedSecond);
+  // the least recently used one is evicted, handles already returned stay valid
+  EXPECT_NE(hermes->prepare(first), preparedFirst);
+  EXPECT_EQ(hermes->evaluatePrepared(preparedFirst).asNumber().toInt32(), 1);
+
+  // too large to be cached at all
+  hermes_backend::HermesEngine::setPreparedCacheMaxBytes(4);
+  EXPECT_NE(hermes->prepare(second), hermes->prepare(second));
+
+  // the source alone fits, but not with its prepared script
+  hermes_backend::HermesEngine::setPreparedCacheMaxBytes(2 * second.size() - 1);
+  EXPECT_NE(hermes->prepare(second), hermes->prepare(second));
+
+  hermes_backend::HermesEngine::setPreparedCacheMaxBytes(
+      hermes_backend::HermesEngine::kDefaultPreparedCacheMaxBytes);
+  hermes_backend::HermesEngine::clearPreparedCache();
+}
+
+TEST_F(EngineTest, HermesHeapOptions) {
+  EngineOptions options;
+  options.initialHeapSize = 4 * 1024 * 1024;
+  options.maxHeapSize = 64 * 1024 * 1024;
+  options.nearHeapLimitCallback = [](ScriptEngine*) {};
+
+  auto hermes = new hermes_backend::HermesEngine({}, options);
+  {
+    EngineScope engineScope(hermes);
+    EXPECT_EQ(hermes->eval("1 + 1").asNumber().toInt32(), 2);
+    hermes->gc();
+
+    auto statistics = hermes->getHeapStatistics();
+    EXPECT_EQ(statistics.heapSizeLimit, options.maxHeapSize);
+    EXPECT_GT(statistics.usedHeapSize, 0);
+    EXPECT_GT(statistics.gcCount, 0);
+  }
+  hermes->destroy();
+}
+#endif
+
+#ifdef SCRIPTX_BACKEND_V8
+TEST_F(EngineTest, V8CodeCache) {
+  auto store = std::make_shared<utils::LruCodeCacheStore>();
+  auto source = "(function (a, b) { return a * b; })(6, 7);";
+
+  auto v8Engine = static_cast<v8_backend::V8Engine*>(engine);
+  v8Engine->setCodeCacheStore(store);
+  {
+    EngineScope engineScope(engine);
+    EXPECT_EQ(engine->eval(source).asNumber().toInt32(), 42);
+    EXPECT_EQ(v8Engine->codeCacheMissCount(), 1);
+    EXPECT_EQ(v8Engine->codeCacheHitCount(), 0);
+    EXPECT_EQ(store->size(), 1);
+  }
+
+  // another isolate consumes the cache produced above
+  auto other = new v8_backend::V8Engine();
+  other->setCodeCacheStore(store);
+  {
+    EngineScope engineScope(other);
+    EXPECT_EQ(other->eval(source).asNumber().toInt32(), 42);
+    EXPECT_EQ(other->codeCacheMissCount(), 0);
+    EXPECT_EQ(other->codeCacheHitCount(), 1);
+  }
+  other->destroy();
+}
+
+TEST_F(EngineTest, V8Snapshot) {
+  auto snapshot = v8_backend::V8Engine::createSnapshot(
+      {"var bootstrap = { answer: 42 };", "bootstrap.twice = function () { return 84; };"});
+  ASSERT_TRUE(snapshot != nullptr);
+
+  auto snapshotEngine = new v8_backend::V8Engine({}, snapshot);
+  {
+    EngineScope engineScope(snapshotEngine);
+    EXPECT_EQ(snapshotEngine->eval("bootstrap.answer").asNumber().toInt32(), 42);
+    EXPECT_EQ(snapshotEngine->eval("bootstrap.twice()").asNumber().toInt32(), 84);
+  }
+  snapshotEngine->destroy();
+
+  EXPECT_THROW(v8_backend::V8Engine::createSnapshot({"throw new Error('boom');"}), Exception);
+}
+
+TEST_F(EngineTest, V8HeapOptions) {
+  EngineOptions options;
+  options.maxHeapSize = 64 * 1024 * 1024;
+  options.nearHeapLimitCallback = [](ScriptEngine*) {};
+
+  auto v8Engine = new v8_backend::V8Engine({}, options);
+  {
+    EngineScope engineScope(v8Engine);
+    EXPECT_EQ(v8Engine->eval("1 + 1").asNumber().toInt32(), 2);
+
+    auto statistics = v8Engine->getHeapStatistics();
+    EXPECT_GT(statistics.heapSizeLimit, 0);
+    EXPECT_LE(statistics.heapSizeLimit, 2 * options.maxHeapSize);
+    EXPECT_GT(statistics.usedHeapSize, 0);
+  }
+  v8Engine->destroy();
+}
+
+TEST_F(EngineTest, V8StartupBenchmark) {
+  SKIP_UNLESS_BENCHMARK_ENABLED();
+
+  constexpr int kRound = 20;
+  // a bootstrap bundle with a lot of functions
+  std::ostringstream bundle;
+  bundle << "var bootstrap = {};";
+  for (int i = 0; i < 20000; ++i) {
+    bundle << "bootstrap.f" << i << " = function (a, b) { var x = a + " << i
+           << "; return x * b + [a, b].map(function (v) { return v + 1; }).length; };";
+  }
+  bundle << "bootstrap.f0(1, 2);";
+  auto source = bundle.str();
+
+  auto run = [&](const char* name, auto&& create) {
+    runBenchmark(name, kRound, [&]() {
+      for (int i = 0; i < kRound; ++i) {
+        auto e = create();
+        {
+          EngineScope engineScope(e);
+          ASSERT_TRUE(e->eval("bootstrap.f1(1, 2)").isNumber());
+        }
+        e->destroy();
+      }
+    });
+  };
+
+  run("cold", [&]() {
+    auto e = new v8_backend::V8Engine();
+    EngineScope engineScope(e);
+    e->eval(source);
+    return e;
+  });
+
+  auto store = std::make_shared<utils::LruCodeCacheStore>();
+  run("cached", [&]() {
+    auto e = new v8_backend::V8Engine();
+    e->setCodeCacheStore(store);
+    EngineScope engineScope(e);
+    e->eval(source);
+    return e;
+  });
+
+  auto snapshot = v8_backend::V8Engine::createSnapshot({source});
+  run("snapshot", [&]() { return new v8_backend::V8Engine({}, snapshot); });
+}
+#endif
+
 }  // namespace script::test
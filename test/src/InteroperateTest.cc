@@ -15,8 +15,27 @@
  * limitations under the License.
  */
 
+#include <atomic>
+#include <cstdlib>
+#include <new>
 #include "test.h"
 
+#if defined(SCRIPTX_BACKEND_HERMES) && defined(SCRIPTX_TEST_ENABLE_BENCHMARK)
+// counts heap allocations for HermesHandleArenaBenchmark,
+// it replaces the allocator of the whole test binary so only for benchmark builds.
+static std::atomic_size_t gHeapAllocationCount{0};
+
+void* operator new(std::size_t size) {
+  gHeapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+  if (auto ptr = std::malloc(size == 0 ? 1 : size)) return ptr;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+#endif
+
 namespace script::test {
 
 DEFINE_ENGINE_TEST(InteroperateTest);
@@ -60,6 +79,92 @@ TEST_F(InteroperateTest, Hermes) {
   EXPECT_EQ(ret.asNumber().toInt32(), 3);
 }
 
+TEST_F(InteroperateTest, HermesHandleArena) {
+  EngineScope scope(engine);
+  auto eng = EngineScope::currentEngineAs<hermes_backend::HermesEngine>();
+  auto& arena = hermes_interop::getHandleArena(eng);
+
+  auto add = Function::newFunction([](int a, int b, int c) { return a + b + c; });
+  engine->set("add", add);
+
+  {
+    StackFrameScope stack;
+    engine->eval("for (let i = 0; i < 100; ++i) add(1, 2, 3);");
+  }
+
+  const auto size = arena.size();
+  const auto blocks = arena.blockAllocations();
+  {
+    StackFrameScope stack;
+    auto ret = engine->eval(
+        "let sum = 0; for (let i = 0; i < 100000; ++i) sum += add(i, 2, 3); sum");
+    EXPECT_TRUE(ret.isNumber());
+  }
+
+  // locals of every call are released when the call returns
+  EXPECT_EQ(arena.size(), size);
+  EXPECT_EQ(arena.blockAllocations(), blocks);
+
+  Local<Value> escaped;
+  {
+    StackFrameScope stack;
+    auto str = String::newString("escaped");
+    escaped = stack.returnValue(str);
+  }
+  EXPECT_EQ(arena.size(), size + 1);
+  EXPECT_STREQ(escaped.asString().toString().c_str(), "escaped");
+}
+
+TEST_F(InteroperateTest, HermesLocalReset) {
+  EngineScope scope(engine);
+  Local<Value> value = Number::newNumber(1);
+  value.reset();
+  EXPECT_TRUE(value.isNull());
+  EXPECT_TRUE(hermes_interop::toHermes(value)->isNull());
+  EXPECT_EQ(value.getKind(), ValueKind::kNull);
+}
+
+TEST_F(InteroperateTest, HermesHandleArenaBenchmark) {
+  SKIP_UNLESS_BENCHMARK_ENABLED();
+#ifdef SCRIPTX_TEST_ENABLE_BENCHMARK
+  constexpr auto kCallCount = 1000 * 1000;
+
+  EngineScope scope(engine);
+
+  // "before" is simulated: the shared_ptr ValueHolder no longer exists, so this repeats what it
+  // did on each bound call, a heap allocated jsi::Value per argument handle and one for the
+  // return value. For a real before/after, run the arena side against a baseline build.
+  auto simulated = Function::newFunction([](const Arguments& args) -> Local<Value> {
+    auto& runtime = *hermes_interop::currentEngineRuntime();
+    int sum = 0;
+    for (size_t i = 0; i < args.size(); ++i) {
+      auto handle =
+          std::make_shared<facebook::jsi::Value>(runtime, *hermes_interop::toHermes(args[i]));
+      sum += static_cast<int>(handle->getNumber());
+    }
+    auto ret = std::make_shared<facebook::jsi::Value>(sum);
+    return hermes_interop::makeLocal<Value>(std::move(*ret));
+  });
+  // "after": plain Local<T> from the HandleArena
+  auto arena = Function::newFunction([](int a, int b, int c) { return a + b + c; });
+
+  auto run = [&](const char* name, const Local<Function>& func) {
+    engine->set("f", func);
+    auto allocations = gHeapAllocationCount.load();
+    runBenchmark(name, kCallCount, [&]() {
+      StackFrameScope stack;
+      engine->eval("for (let i = 0; i < " + std::to_string(kCallCount) + "; ++i) f(i, 2, 3);");
+    });
+    std::cout << "  heap allocations/call: "
+              << static_cast<double>(gHeapAllocationCount.load() - allocations) / kCallCount
+              << std::endl;
+  };
+
+  run("simulated legacy handles", simulated);
+  run("arena handles", arena);
+#endif
+}
+
 #endif
 
 #ifdef SCRIPTX_BACKEND_JAVASCRIPTCORE
@@ -101,6 +101,65 @@ TEST_F(ManagedObjectTest, CallGcWhilGc) {
   engine->gc();
 }
 
+#if defined(SCRIPTX_BACKEND_QUICKJS) || defined(SCRIPTX_BACKEND_HERMES)
+
+namespace {
+
+class LargeNative : public ScriptClass {
+ public:
+  explicit LargeNative(const Local<Object>& thiz) : ScriptClass(thiz) {}
+
+  char payload[64 * 1024]{};
+};
+
+ClassDefine<LargeNative> largeNativeDef =
+    defineClass<LargeNative>("LargeNative").constructor().build();
+
+}  // namespace
+
+TEST_F(ManagedObjectTest, AssociatedMemory) {
+  auto impl = static_cast<ScriptEngineImpl*>(engine);
+  EngineScope engineScope(engine);
+  engine->registerNativeClass(largeNativeDef);
+
+  // accounting only
+  impl->setAssociatedMemoryGcThreshold(0);
+  engine->gc();
+  const auto base = impl->getAssociatedMemory();
+  {
+    StackFrameScope stack;
+    auto instance = engine->newNativeClass<LargeNative>();
+    EXPECT_GE(impl->getAssociatedMemory(), base + sizeof(LargeNative));
+
+    constexpr size_t kBufferSize = 1024;
+    [[maybe_unused]] const auto heapBefore = engine->getHeapStatistics().totalHeapSize;
+    auto buffer = ByteBuffer::newByteBuffer(
+        std::shared_ptr<void>(new char[kBufferSize], std::default_delete<char[]>()),
+        kBufferSize);
+    EXPECT_GE(impl->getAssociatedMemory(), base + sizeof(LargeNative) + kBufferSize);
+    EXPECT_GE(engine->getHeapSize(), impl->getAssociatedMemory());
+    EXPECT_GE(engine->getHeapStatistics().externalMemory, kBufferSize);
+#ifdef SCRIPTX_BACKEND_QUICKJS
+    // the buffer is added to the malloc state of the runtime on the next allocation
+    Object::newObject();
+    EXPECT_GE(engine->getHeapStatistics().totalHeapSize, heapBefore + kBufferSize);
+#endif
+  }
+  engine->gc();
+  EXPECT_EQ(impl->getAssociatedMemory(), base);
+
+  // garbage instances are collected once the threshold is crossed, without explicit gc
+  constexpr size_t kBatch = 4;
+  impl->setAssociatedMemoryGcThreshold(kBatch * sizeof(LargeNative));
+  for (int i = 0; i < 64; ++i) {
+    StackFrameScope stack;
+    engine->newNativeClass<LargeNative>();
+  }
+  EXPECT_LT(impl->getAssociatedMemory(), base + 2 * kBatch * sizeof(LargeNative));
+}
+
+#endif
+
 #ifdef SCRIPTX_BACKEND_V8
 // V8Engine specific test
 
@@ -16,6 +16,8 @@
  */
 
 #include <atomic>
+#include <chrono>
+#include <vector>
 #include "test.h"
 
 namespace script::utils {
@@ -208,4 +210,329 @@ TEST(MessageQueue, FullAndPostInsideLoopQueue) {
   q.shutdown(true);
 }
 
+TEST(MessageQueue, MultiProducer) {
+  constexpr int kProducer = 8;
+  constexpr int kMessagePerProducer = 10000;
+
+  std::atomic_int32_t count = 0;
+  Message inc([](Message& m) { (*static_cast<std::atomic_int32_t*>(m.ptr0))++; }, nullptr);
+  inc.ptr0 = &count;
+
+  MessageQueue queue;
+  std::thread consumer([&queue]() { queue.loopQueue(MessageQueue::LoopType::kLoopAndWait); });
+
+  std::vector<std::thread> producers;
+  for (int i = 0; i < kProducer; ++i) {
+    producers.emplace_back([&]() {
+      for (int j = 0; j < kMessagePerProducer; ++j) {
+        EXPECT_NE(queue.postMessage(inc), 0);
+      }
+    });
+  }
+  for (auto& t : producers) t.join();
+
+  queue.shutdown(true);
+  consumer.join();
+  EXPECT_EQ(count, kProducer * kMessagePerProducer);
+}
+
+TEST(MessageQueue, RemoveZeroDelayMessage) {
+  size_t count = 0;
+  Message inc([](Message& m) { (*static_cast<size_t*>(m.ptr0))++; }, nullptr);
+  inc.ptr0 = &count;
+
+  MessageQueue queue;
+  queue.postMessage(inc);
+  auto id = queue.postMessage(inc);
+  queue.postMessage(inc);
+
+  // zero-delay messages are removable before the looper ever sees them
+  EXPECT_TRUE(queue.removeMessage(id));
+  EXPECT_FALSE(queue.removeMessage(id));
+  queue.loopQueue(MessageQueue::LoopType::kLoopOnce);
+  EXPECT_EQ(count, 2);
+
+  queue.shutdownNow();
+  EXPECT_EQ(queue.postMessage(inc), 0);
+}
+
+TEST(MessageQueue, ContentionBenchmark) {
+  SKIP_UNLESS_BENCHMARK_ENABLED();
+
+  constexpr int kTotalMessage = 1000000;
+
+  for (int producerCount : {1, 4, 16, 64}) {
+    std::atomic_int32_t count = 0;
+    Message inc([](Message& m) { (*static_cast<std::atomic_int32_t*>(m.ptr0))++; }, nullptr);
+    inc.ptr0 = &count;
+
+    MessageQueue queue;
+    std::thread consumer([&queue]() { queue.loopQueue(MessageQueue::LoopType::kLoopAndWait); });
+
+    auto name = "producers: " + std::to_string(producerCount);
+    test::runBenchmark(name.c_str(), kTotalMessage, [&]() {
+      std::vector<std::thread> producers;
+      for (int i = 0; i < producerCount; ++i) {
+        producers.emplace_back([&]() {
+          for (int j = 0; j < kTotalMessage / producerCount; ++j) {
+            queue.postMessage(inc);
+          }
+        });
+      }
+      for (auto& t : producers) t.join();
+      queue.shutdown(true);
+      consumer.join();
+    });
+    EXPECT_EQ(count.load(), kTotalMessage / producerCount * producerCount);
+  }
+}
+
+TEST(MessageQueue, DelayedOrderAndCancel) {
+  constexpr int kMessage = 200;
+  std::vector<int> executed;
+  int cleanup = 0;
+
+  Message record(
+      [](Message& m) {
+        static_cast<std::vector<int>*>(m.ptr0)->push_back(static_cast<int>(m.data0));
+      },
+      [](Message& m) { (*static_cast<int*>(m.ptr1))++; });
+  record.ptr0 = &executed;
+  record.ptr1 = &cleanup;
+
+  MessageQueue queue;
+  std::vector<int32_t> ids;
+  // post in reverse due order
+  for (int i = kMessage - 1; i >= 0; --i) {
+    record.data0 = i;
+    ids.push_back(queue.postMessage(record, std::chrono::microseconds(100 * i)));
+  }
+
+  // cancel all odd ones, cleanup is called right away
+  for (int i = 0; i < kMessage; ++i) {
+    if (i % 2 == 1) {
+      EXPECT_TRUE(queue.removeMessage(ids[kMessage - 1 - i]));
+    }
+  }
+  EXPECT_EQ(cleanup, kMessage / 2);
+  EXPECT_FALSE(queue.removeMessage(ids[kMessage - 2]));
+
+  std::this_thread::sleep_for(std::chrono::microseconds(100 * kMessage));
+  queue.loopQueue(MessageQueue::LoopType::kLoopOnce);
+
+  ASSERT_EQ(executed.size(), kMessage / 2);
+  for (size_t i = 0; i < executed.size(); ++i) {
+    EXPECT_EQ(executed[i], static_cast<int>(i * 2));
+  }
+  EXPECT_EQ(cleanup, kMessage);
+  // executed messages can't be removed
+  EXPECT_FALSE(queue.removeMessage(ids.back()));
+}
+
+TEST(MessageQueue, ManyTimersRemove) {
+  constexpr int kTimer = 5000;
+  int handled = 0;
+  int cleanup = 0;
+  Message count([](Message& m) { (*static_cast<int*>(m.ptr0))++; },
+                [](Message& m) { (*static_cast<int*>(m.ptr1))++; });
+  count.ptr0 = &handled;
+  count.ptr1 = &cleanup;
+
+  MessageQueue queue;
+  std::vector<int32_t> ids;
+  ids.reserve(kTimer);
+  for (int i = 0; i < kTimer; ++i) {
+    ids.push_back(queue.postMessage(count, std::chrono::seconds(1 + i % 1000)));
+  }
+
+  // remove every other timer, tombstones get compacted along the way
+  for (int i = 0; i < kTimer; i += 2) {
+    EXPECT_TRUE(queue.removeMessage(ids[i]));
+  }
+  for (int i = 0; i < kTimer; i += 2) {
+    EXPECT_FALSE(queue.removeMessage(ids[i]));
+  }
+  EXPECT_EQ(cleanup, kTimer / 2);
+
+  // none of the timers is due
+  queue.postMessage(count);
+  queue.loopQueue(MessageQueue::LoopType::kLoopOnce);
+  EXPECT_EQ(handled, 1);
+  EXPECT_EQ(cleanup, kTimer / 2 + 1);
+
+  for (int i = 1; i < kTimer; i += 2) {
+    EXPECT_TRUE(queue.removeMessage(ids[i]));
+  }
+  EXPECT_EQ(cleanup, kTimer + 1);
+  EXPECT_EQ(handled, 1);
+}
+
+TEST(MessageQueue, PostMessagesBatch) {
+  std::vector<int> executed;
+  Message record(
+      [](Message& m) {
+        static_cast<std::vector<int>*>(m.ptr0)->push_back(static_cast<int>(m.data0));
+      },
+      nullptr);
+  record.ptr0 = &executed;
+
+  std::vector<Message> batch(100, record);
+  for (size_t i = 0; i < batch.size(); ++i) {
+    batch[i].data0 = static_cast<int64_t>(i);
+  }
+  // higher priority runs first inside the same batch
+  batch.back().priority = -1;
+
+  for (auto bounded : {false, true}) {
+    executed.clear();
+    MessageQueue queue(bounded ? 1000 : MessageQueue::kDefaultMaxMessageInQueue);
+    std::vector<int32_t> ids(batch.size());
+    EXPECT_EQ(queue.postMessages(std::span<const Message>(batch), std::chrono::milliseconds(0),
+                                 std::span<int32_t>(ids)),
+              batch.size());
+    EXPECT_TRUE(queue.removeMessage(ids[1]));
+    queue.loopQueue(MessageQueue::LoopType::kLoopOnce);
+
+    ASSERT_EQ(executed.size(), batch.size() - 1);
+    EXPECT_EQ(executed.front(), 99);
+    EXPECT_EQ(executed[1], 0);
+    for (size_t i = 2; i < executed.size(); ++i) {
+      EXPECT_EQ(executed[i], static_cast<int>(i));
+    }
+
+    queue.shutdownNow();
+    EXPECT_EQ(queue.postMessages(std::span<const Message>(batch)), 0);
+  }
+}
+
+namespace {
+class CountingSupervisor : public MessageQueue::Supervisor {
+ public:
+  int before = 0;
+  int after = 0;
+
+ protected:
+  void beforeMessage(Message&) override { before++; }
+
+  void afterMessage(Message&) override {
+    EXPECT_EQ(before, after + 1);
+    after++;
+  }
+};
+}  // namespace
+
+TEST(MessageQueue, DrainAllDue) {
+  int count = 0;
+  Message inc([](Message& m) { (*static_cast<int*>(m.ptr0))++; }, nullptr);
+  inc.ptr0 = &count;
+
+  auto supervisor = std::make_shared<CountingSupervisor>();
+  MessageQueue queue;
+  queue.setSupervisor(supervisor);
+
+  std::vector<Message> batch(50, inc);
+  queue.postMessages(std::span<const Message>(batch));
+  queue.postMessage(inc, std::chrono::hours(1));
+  queue.loopQueue(MessageQueue::LoopType::kLoopOnce, MessageQueue::kDrainAllDue);
+
+  // the delayed one is not due
+  EXPECT_EQ(count, 50);
+  EXPECT_EQ(supervisor->before, 50);
+  EXPECT_EQ(supervisor->after, 50);
+
+  // interrupt in the middle of a batch puts the rest back
+  Message interrupt([](Message& m) { static_cast<MessageQueue*>(m.ptr0)->interrupt(); }, nullptr);
+  interrupt.ptr0 = &queue;
+  queue.postMessage(interrupt);
+  queue.postMessages(std::span<const Message>(batch));
+  queue.loopQueue(MessageQueue::LoopType::kLoopAndWait, MessageQueue::kDrainAllDue);
+  EXPECT_EQ(count, 50);
+
+  queue.loopQueue(MessageQueue::LoopType::kLoopOnce, MessageQueue::kDrainAllDue);
+  EXPECT_EQ(count, 100);
+}
+
+TEST(MessageQueue, BatchWithConsumerThread) {
+  constexpr int kTotalMessage = 10000;
+
+  for (size_t batchSize : {1, 16, 256}) {
+    std::atomic_int32_t count = 0;
+    Message inc([](Message& m) { (*static_cast<std::atomic_int32_t*>(m.ptr0))++; }, nullptr);
+    inc.ptr0 = &count;
+    std::vector<Message> batch(batchSize, inc);
+
+    MessageQueue queue;
+    std::thread consumer([&queue, batchSize]() {
+      queue.loopQueue(MessageQueue::LoopType::kLoopAndWait, batchSize);
+    });
+
+    int posted = 0;
+    while (posted < kTotalMessage) {
+      posted += static_cast<int>(queue.postMessages(std::span<const Message>(batch)));
+    }
+    queue.shutdown(true);
+    consumer.join();
+
+    EXPECT_EQ(count.load(), posted);
+  }
+}
+
+TEST(MessageQueue, BoundedBatchLargerThanCapacity) {
+  constexpr size_t kCapacity = 4;
+  constexpr int kRounds = 100;
+
+  std::atomic_int32_t count = 0;
+  Message inc([](Message& m) { (*static_cast<std::atomic_int32_t*>(m.ptr0))++; }, nullptr);
+  inc.ptr0 = &count;
+  std::vector<Message> batch(kCapacity * 2 + 2, inc);
+
+  MessageQueue queue(kCapacity);
+  std::thread consumer([&queue]() { queue.loopQueue(MessageQueue::LoopType::kLoopAndWait); });
+
+  // the producer waits for space in the middle of each batch
+  size_t posted = 0;
+  for (int i = 0; i < kRounds; ++i) {
+    posted += queue.postMessages(std::span<const Message>(batch));
+  }
+  queue.shutdown(true);
+  consumer.join();
+
+  EXPECT_EQ(posted, batch.size() * kRounds);
+  EXPECT_EQ(count.load(), static_cast<int32_t>(posted));
+}
+
+TEST(MessageQueue, BatchBenchmark) {
+  SKIP_UNLESS_BENCHMARK_ENABLED();
+
+  constexpr int kTotalMessage = 1000000;
+
+  for (size_t batchSize : {1, 16, 256}) {
+    std::atomic_int32_t count = 0;
+    Message inc([](Message& m) { (*static_cast<std::atomic_int32_t*>(m.ptr0))++; }, nullptr);
+    inc.ptr0 = &count;
+    std::vector<Message> batch(batchSize, inc);
+
+    MessageQueue queue;
+    std::thread consumer([&queue, batchSize]() {
+      queue.loopQueue(MessageQueue::LoopType::kLoopAndWait, batchSize);
+    });
+
+    auto rounds = kTotalMessage / static_cast<int>(batchSize);
+    auto name = batchSize == 1 ? std::string("postMessage")
+                               : "postMessages: " + std::to_string(batchSize);
+    test::runBenchmark(name.c_str(), rounds * batchSize, [&]() {
+      for (int i = 0; i < rounds; ++i) {
+        if (batchSize == 1) {
+          queue.postMessage(inc);
+        } else {
+          queue.postMessages(std::span<const Message>(batch));
+        }
+      }
+      queue.shutdown(true);
+      consumer.join();
+    });
+    EXPECT_EQ(count.load(), rounds * static_cast<int>(batchSize));
+  }
+}
+
 }  // namespace script::utils
@@ -15,6 +15,7 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <sstream>
 #include "test.h"
 
@@ -789,6 +790,14 @@ class InstanceOfTest : public script::ScriptClass {
 
 auto instanceOfTestDefine = defineClass<InstanceOfTest>("InstanceOfTest").constructor().build();
 
+class OtherInstanceOfTest : public script::ScriptClass {
+ public:
+  using ScriptClass::ScriptClass;
+};
+
+auto otherInstanceOfTestDefine =
+    defineClass<OtherInstanceOfTest>("OtherInstanceOfTest").constructor().build();
+
 }  // namespace
 
 TEST_F(NativeTest, InstanceOfTest) {
@@ -833,6 +842,47 @@ TEST_F(NativeTest, InstanceOfTest) {
   }
 }
 
+TEST_F(NativeTest, GetNativeInstance) {
+  EngineScope scope(engine);
+  engine->registerNativeClass(instanceOfTestDefine);
+
+  auto ins = engine->newNativeClass<InstanceOfTest>();
+  auto ptr = engine->getNativeInstance<InstanceOfTest>(ins);
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_TRUE(ptr->getScriptObject() == ins);
+
+  auto scriptCreated =
+      engine->eval(TS().js("new InstanceOfTest()").lua("return InstanceOfTest()").select());
+  EXPECT_NE(engine->getNativeInstance<InstanceOfTest>(scriptCreated), nullptr);
+
+  EXPECT_EQ(engine->getNativeInstance<InstanceOfTest>(Object::newObject()), nullptr);
+  EXPECT_EQ(engine->getNativeInstance<InstanceOfTest>(Number::newNumber(0)), nullptr);
+
+  // instance of another class
+  engine->registerNativeClass(otherInstanceOfTestDefine);
+  auto other = engine->newNativeClass<OtherInstanceOfTest>();
+  EXPECT_EQ(engine->getNativeInstance<InstanceOfTest>(other), nullptr);
+  EXPECT_NE(engine->getNativeInstance<OtherInstanceOfTest>(other), nullptr);
+
+#ifdef SCRIPTX_BACKEND_HERMES
+  // native states not holding an instance
+  struct ForeignState : facebook::jsi::NativeState {};
+  auto& runtime = *hermes_interop::currentEngineRuntime();
+  auto foreign = facebook::jsi::Object(runtime);
+  foreign.setNativeState(runtime, std::make_shared<ForeignState>());
+  EXPECT_EQ(engine->getNativeInstance<InstanceOfTest>(
+                hermes_interop::makeLocal<Object>(std::move(foreign))),
+            nullptr);
+
+  auto nonOwning = facebook::jsi::Object(runtime);
+  nonOwning.setNativeState(
+      runtime, std::make_shared<hermes_backend::NonOwningSharedScriptClassHolder>(ptr));
+  EXPECT_EQ(engine->getNativeInstance<InstanceOfTest>(
+                hermes_interop::makeLocal<Object>(std::move(nonOwning))),
+            nullptr);
+#endif
+}
+
 TEST_F(NativeTest, TypedAPIClassDefineTest) {
   EngineScope engineScope(engine);
   engine->registerNativeClass(instanceOfTestDefine);
@@ -1123,6 +1173,265 @@ TEST_F(NativeTest, OverloadedFunction) {
   EXPECT_THROW({ fun.call({}, false); }, Exception);
 }
 
+namespace {
+
+int addThree(int a, int b, int c) { return a + b + c; }
+
+size_t stringLength(std::string_view str) { return str.length(); }
+
+class DirectBind : public ScriptClass {
+ public:
+  int base = 0;
+
+  explicit DirectBind(const Local<Object>& scriptObject) : ScriptClass(scriptObject) {}
+
+  int add(int a, int b, int c) { return base + a + b + c; }
+
+  void setBase(int value) { base = value; }
+
+  std::string greet(const std::string& name) const { return "hello " + name; }
+};
+
+}  // namespace
+
+TEST_F(NativeTest, CompileTimeBind) {
+  EngineScope scope(engine);
+  static auto define = defineClass<DirectBind>("DirectBind")
+                           .constructor()
+                           .function<&addThree>("addThree")
+                           .function<&stringLength>("length")
+                           .instanceFunction<&DirectBind::add>("add")
+                           .instanceFunction<&DirectBind::setBase>("setBase")
+                           .instanceFunction<&DirectBind::greet>("greet")
+                           .build();
+  engine->registerNativeClass(define);
+
+  auto ret = engine->eval(TS().js("DirectBind.addThree(1, 2, 3)")
+                              .lua("return DirectBind.addThree(1, 2, 3)")
+                              .select());
+  EXPECT_EQ(ret.asNumber().toInt32(), 6);
+  ret = engine->eval(
+      TS().js("DirectBind.length('hello')").lua("return DirectBind.length('hello')").select());
+  EXPECT_EQ(ret.asNumber().toInt32(), 5);
+
+  auto ins = engine->newNativeClass<DirectBind>();
+  ins.get("setBase").asFunction().call(ins, 10);
+  EXPECT_EQ(engine->getNativeInstance<DirectBind>(ins)->base, 10);
+  ret = ins.get("add").asFunction().call(ins, 1, 2, 3);
+  EXPECT_EQ(ret.asNumber().toInt32(), 16);
+  ret = ins.get("greet").asFunction().call(ins, "ScriptX");
+  EXPECT_EQ(ret.asString().toString(), "hello ScriptX");
+
+  EXPECT_THROW({ ins.get("add").asFunction().call(ins, 1, 2); }, Exception);
+  EXPECT_THROW({ ins.get("add").asFunction().call(ins, 1, 2, "3"); }, Exception);
+}
+
+TEST_F(NativeTest, CompileTimeBindBenchmark) {
+  SKIP_UNLESS_BENCHMARK_ENABLED();
+
+  EngineScope scope(engine);
+  static auto define = defineClass<DirectBind>("DirectBindBenchmark")
+                           .constructor()
+                           .function("addThree", &addThree)
+                           .function<&addThree>("addThreeDirect")
+                           .instanceFunction("add", &DirectBind::add)
+                           .instanceFunction<&DirectBind::add>("addDirect")
+                           .build();
+  engine->registerNativeClass(define);
+  auto ins = engine->newNativeClass<DirectBind>();
+  auto clazz = engine->get("DirectBindBenchmark").asObject();
+
+  constexpr int kCalls = 1000000;
+  auto run = [&](const char* name, const Local<Object>& thiz) {
+    auto func = thiz.get(name).asFunction();
+    auto a = Number::newNumber(1);
+    auto b = Number::newNumber(2);
+    auto c = Number::newNumber(3);
+    runBenchmark(name, kCalls, [&]() {
+      for (int i = 0; i < kCalls; ++i) {
+        func.call(thiz, a, b, c);
+      }
+    });
+  };
+
+  run("addThree", clazz);
+  run("addThreeDirect", clazz);
+  run("add", ins);
+  run("addDirect", ins);
+}
+
+TEST_F(NativeTest, ContainerConverter) {
+  EngineScope scope(engine);
+
+  auto sum = Function::newFunction([](const std::vector<int>& v) {
+    int ret = 0;
+    for (auto i : v) ret += i;
+    return ret;
+  });
+  EXPECT_EQ(sum.call({}, std::vector<int>{1, 2, 3}).asNumber().toInt32(), 6);
+
+  auto reverse = Function::newFunction([](std::vector<std::string> v) {
+    std::reverse(v.begin(), v.end());
+    return v;
+  });
+  auto reversed = reverse.call({}, Array::newArray({String::newString("a"),
+                                                    String::newString("b")}));
+  ASSERT_TRUE(reversed.isArray());
+  EXPECT_EQ(reversed.asArray().size(), 2);
+  EXPECT_EQ(reversed.asArray().get(0).asString().toString(), "b");
+
+  auto vec3 = converter::Converter<std::array<double, 3>>::toScript({1.5, 2.5, 3.5});
+  auto back = converter::Converter<std::array<double, 3>>::toCpp(vec3);
+  EXPECT_EQ(back[2], 3.5);
+  EXPECT_THROW({ (converter::Converter<std::array<double, 2>>::toCpp(vec3)); }, Exception);
+
+  std::map<std::string, int> scores{{"alice", 1}, {"bob", 2}};
+  auto object = converter::Converter<decltype(scores)>::toScript(scores);
+  ASSERT_TRUE(object.isObject());
+  EXPECT_EQ(object.asObject().get("bob").asNumber().toInt32(), 2);
+  auto unordered = converter::Converter<std::unordered_map<std::string, int>>::toCpp(object);
+  EXPECT_EQ(unordered.size(), 2);
+  EXPECT_EQ(unordered["alice"], 1);
+
+  auto optional = Function::newFunction(
+      [](std::optional<int> v) -> std::optional<int> { return v ? std::optional(*v * 2) : v; });
+  EXPECT_TRUE(optional.call({}, Local<Value>()).isNull());
+  EXPECT_EQ(optional.call({}, 21).asNumber().toInt32(), 42);
+
+#ifndef SCRIPTX_BACKEND_WEBASSEMBLY
+  // typed array fast path
+  std::vector<float> floats{1.0f, 2.0f, 3.0f};
+  auto typed = engine->eval(TS().js("new Float32Array([1, 2, 3])").lua("return nil").select());
+  if (typed.isByteBuffer() && typed.asByteBuffer().getType() == ByteBuffer::Type::kFloat32) {
+    EXPECT_EQ(converter::Converter<std::vector<float>>::toCpp(typed), floats);
+    EXPECT_THROW({ converter::Converter<std::vector<int32_t>>::toCpp(typed); }, Exception);
+  }
+#endif
+}
+
+}  // namespace script::test
+
+namespace script::test {
+namespace {
+
+struct Vec2 {
+  double x = 0;
+  double y = 0;
+};
+
+struct Sprite {
+  std::string name;
+  Vec2 position;
+  std::optional<int> layer;
+};
+
+}  // namespace
+}  // namespace script::test
+
+namespace script::converter {
+
+template <>
+struct StructFields<test::Vec2> {
+  static constexpr auto fields =
+      std::make_tuple(SCRIPTX_STRUCT_FIELD(test::Vec2, x), SCRIPTX_STRUCT_FIELD(test::Vec2, y));
+};
+
+template <>
+struct StructFields<test::Sprite> {
+  static constexpr auto fields = std::make_tuple(SCRIPTX_STRUCT_FIELD(test::Sprite, name),
+                                                 SCRIPTX_STRUCT_FIELD(test::Sprite, position),
+                                                 SCRIPTX_STRUCT_FIELD(test::Sprite, layer));
+};
+
+}  // namespace script::converter
+
+namespace script::test {
+
+TEST_F(NativeTest, StructConverter) {
+  EngineScope scope(engine);
+
+  auto move = Function::newFunction([](Sprite sprite, const Vec2& delta) {
+    sprite.position.x += delta.x;
+    sprite.position.y += delta.y;
+    return sprite;
+  });
+
+  Sprite sprite{"hero", {1, 2}, std::nullopt};
+  auto ret = move.call({}, sprite, Vec2{10, 20});
+  ASSERT_TRUE(ret.isObject());
+  auto object = ret.asObject();
+  EXPECT_EQ(object.get("name").asString().toString(), "hero");
+  EXPECT_EQ(object.get("position").asObject().get("x").asNumber().toDouble(), 11);
+  EXPECT_TRUE(object.get("layer").isNull());
+
+  object.set("layer", 3);
+  auto back = converter::Converter<Sprite>::toCpp(object);
+  EXPECT_EQ(back.name, "hero");
+  EXPECT_EQ(back.position.y, 22);
+  ASSERT_TRUE(back.layer.has_value());
+  EXPECT_EQ(*back.layer, 3);
+
+  auto fromScript = engine->eval(TS().js("({x: 5, y: 6})").lua("return {x = 5, y = 6}").select());
+  auto vec = converter::Converter<Vec2>::toCpp(fromScript);
+  EXPECT_EQ(vec.x, 5);
+  EXPECT_EQ(vec.y, 6);
+
+  EXPECT_THROW({ converter::Converter<Vec2>::toCpp(Number::newNumber(1)); }, Exception);
+}
+
+TEST_F(NativeTest, StructConverterInternedKeys) {
+  EngineScope scope(engine);
+  // field keys are interned once per engine, and must stay valid across stack frames
+  for (int i = 0; i < 100; ++i) {
+    StackFrameScope frame;
+    Vec2 vec{i * 0.5, -i * 0.5};
+    auto object = converter::Converter<Vec2>::toScript(vec);
+    auto back = converter::Converter<Vec2>::toCpp(object);
+    EXPECT_EQ(back.x, vec.x);
+    EXPECT_EQ(back.y, vec.y);
+    EXPECT_EQ(object.asObject().get("x").asNumber().toDouble(), vec.x);
+  }
+}
+
+TEST_F(NativeTest, StructConverterBenchmark) {
+  SKIP_UNLESS_BENCHMARK_ENABLED();
+
+  EngineScope scope(engine);
+  constexpr int kCount = 100000;
+  Vec2 vec{1.5, -2.5};
+
+  // both sides do one Object::set per field, the converter only saves the key string creation
+  runBenchmark("hand-written set()", kCount, [&]() {
+    for (int i = 0; i < kCount; ++i) {
+      StackFrameScope frame;
+      auto object = Object::newObject();
+      object.set(String::newString("x"), Number::newNumber(vec.x));
+      object.set(String::newString("y"), Number::newNumber(vec.y));
+    }
+  });
+  runBenchmark("StructConverter", kCount, [&]() {
+    for (int i = 0; i < kCount; ++i) {
+      StackFrameScope frame;
+      converter::Converter<Vec2>::toScript(vec);
+    }
+  });
+}
+
+TEST_F(NativeTest, OverloadedFunctionArray) {
+  EngineScope scope(engine);
+  auto overloaded = script::adaptOverLoadedFunction(
+      [](const std::string&) { return -1; },
+      [](Local<Array> array) { return static_cast<int>(array.size()); },
+      [](double, double) { return -2; });
+  auto fun = Function::newFunction(overloaded);
+
+  auto array = Array::newArray({Number::newNumber(1), Number::newNumber(2), Number::newNumber(3)});
+  EXPECT_EQ(fun.call({}, array).asNumber().toInt32(), 3);
+  EXPECT_EQ(fun.call({}, "hello").asNumber().toInt32(), -1);
+  EXPECT_EQ(fun.call({}, 1, 2).asNumber().toInt32(), -2);
+  EXPECT_THROW({ fun.call({}, 1); }, Exception);
+}
+
 TEST_F(NativeTest, SelectOverloadedFunction) {
   auto o1 = script::selectOverloadedFunc<int(int)>(overload);
   auto o2 = script::selectOverloadedFunc<int(double)>(overload);
@@ -133,6 +133,58 @@ TEST_F(ReferenceTest, Weak) {
   }
 }
 
+TEST_F(ReferenceTest, GlobalWeakSlotReuse) {
+  EngineScope engineScope(engine);
+  constexpr int kCount = 64;
+
+  std::vector<Global<Value>> globals;
+  std::vector<Weak<Value>> weaks;
+  for (int round = 0; round < 4; ++round) {
+    for (int i = 0; i < kCount; ++i) {
+      auto num = Number::newNumber(round * kCount + i);
+      globals.emplace_back(num);
+      weaks.emplace_back(num);
+    }
+
+    // release every other reference so later ones land in recycled slots
+    for (int i = 0; i < kCount; i += 2) {
+      globals[round * kCount + i].reset();
+      weaks[round * kCount + i].reset();
+    }
+  }
+
+  for (int i = 0; i < static_cast<int>(globals.size()); ++i) {
+    if (i % 2 == 0) {
+      EXPECT_TRUE(globals[i].isEmpty());
+      EXPECT_TRUE(weaks[i].isEmpty());
+    } else {
+      EXPECT_EQ(globals[i].get().asNumber().toInt32(), i);
+      EXPECT_EQ(weaks[i].get().asNumber().toInt32(), i);
+    }
+  }
+}
+
+#ifdef SCRIPTX_BACKEND_LUA
+TEST_F(ReferenceTest, LuaGlobalRegistryDoesNotGrow) {
+  EngineScope engineScope(engine);
+  auto lua = lua_interop::getEngineLua(EngineScope::currentEngineAs<lua_backend::LuaEngine>());
+
+  auto churn = [] {
+    std::vector<Global<Object>> globals;
+    for (int i = 0; i < 128; ++i) {
+      globals.emplace_back(Object::newObject());
+    }
+  };
+
+  churn();
+  auto registrySize = lua_rawlen(lua, LUA_REGISTRYINDEX);
+  for (int i = 0; i < 16; ++i) {
+    churn();
+  }
+  EXPECT_EQ(registrySize, lua_rawlen(lua, LUA_REGISTRYINDEX));
+}
+#endif
+
 TEST_F(ReferenceTest, LocalReset) {
   EngineScope engineScope(engine);
   Local<Value> ref = Object::newObject();
@@ -197,6 +249,38 @@ TEST_F(ReferenceTest, WeakGc) {
   }
 }
 
+#ifdef SCRIPTX_BACKEND_HERMES
+TEST_F(ReferenceTest, WeakReclaimedByGc) {
+  constexpr auto kCount = 32;
+  constexpr auto kChunkSize = 1024 * 1024;
+  std::vector<Weak<Object>> weaks;
+
+  EngineScope engineScope(engine);
+  engine->gc();
+  const auto heapSize = engine->getHeapSize();
+
+  {
+    StackFrameScope inner;
+    std::string chunk(kChunkSize, '.');
+    for (int i = 0; i < kCount; ++i) {
+      auto obj = Object::newObject();
+      obj.set("junk", String::newString(chunk + std::to_string(i)));
+      weaks.emplace_back(obj);
+    }
+  }
+
+  // objects are only reachable through Weak now
+  engine->gc();
+
+  for (auto& weak : weaks) {
+    EXPECT_FALSE(weak.isEmpty());
+    EXPECT_TRUE(weak.getValue().isNull());
+  }
+  EXPECT_LT(engine->getHeapSize(), heapSize + kCount * kChunkSize / 2);
+  weaks.clear();
+}
+#endif
+
 TEST_F(ReferenceTest, WeakGlobal) {
   Weak<String> weak;
   Global<String> global;
@@ -18,7 +18,9 @@
 #include <array>
 #include <atomic>
 #include <cmath>
+#include <future>
 #include <iomanip>
+#include <vector>
 #include "test.h"
 
 namespace script::utils::test {
@@ -155,4 +157,128 @@ TEST(ThreadPool, Benchmark_4p_1w) { runThreadpoolBenchmark<4, 1>(); }
 TEST(ThreadPool, Benchmark_2p_2w) { runThreadpoolBenchmark<2, 2>(); }
 
 TEST(ThreadPool, Benchmark_4p_4w) { runThreadpoolBenchmark<4, 4>(); }
+
+TEST(ThreadPool, WorkStealingRun) {
+  constexpr auto kWorkerCount = 4;
+  constexpr auto max = 1000;
+
+  ThreadPool tp(kWorkerCount, ThreadPool::Mode::kWorkStealing);
+  EXPECT_EQ(kWorkerCount, tp.workerCount());
+  EXPECT_EQ(ThreadPool::Mode::kWorkStealing, tp.mode());
+
+  auto i = std::make_unique<std::atomic_int64_t>();
+
+  // each message posts two more from the worker, which go to the worker's own deque
+  Message spawn(
+      [](Message& msg) {
+        handleMessage(msg);
+        if (msg.data0 > 0) {
+          auto pool = static_cast<ThreadPool*>(msg.ptr1);
+          Message child(msg.getHandlerProc(), nullptr);
+          child.ptr0 = msg.ptr0;
+          child.ptr1 = msg.ptr1;
+          child.data0 = msg.data0 - 1;
+          pool->postMessage(child);
+          pool->postMessage(child);
+        }
+      },
+      nullptr);
+  spawn.ptr0 = i.get();
+  spawn.ptr1 = &tp;
+  spawn.data0 = 3;
+
+  for (int j = 0; j < max; ++j) {
+    EXPECT_NE(tp.postMessage(spawn), 0);
+  }
+
+  // delayed messages are still removable
+  Message msg(handleMessage, nullptr);
+  msg.ptr0 = i.get();
+  tp.postMessage(msg, std::chrono::milliseconds(1));
+  auto id = tp.postMessage(msg, std::chrono::hours(1));
+  tp.removeMessage(id);
+
+  tp.shutdown(true);
+  // 1 + 2 + 4 + 8 per spawn, plus the delayed one
+  EXPECT_EQ(max * 15 + 1, i->load());
+  EXPECT_EQ(0, tp.postMessage(msg));
+}
+
+TEST(ThreadPool, WorkStealingShutdownNow) {
+  std::atomic_int64_t cleanup = 0;
+  {
+    ThreadPool tp(2, ThreadPool::Mode::kWorkStealing);
+    Message msg([](Message&) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); },
+                [](Message& m) { (*static_cast<std::atomic_int64_t*>(m.ptr0))++; });
+    msg.ptr0 = &cleanup;
+    for (int j = 0; j < 100; ++j) {
+      tp.postMessage(msg);
+      tp.postMessage(msg, std::chrono::hours(1));
+    }
+    tp.shutdownNow(true);
+    EXPECT_EQ(0, tp.postMessage(msg));
+  }
+  // every message is cleaned up, whether executed or not
+  EXPECT_EQ(201, cleanup.load());
+}
+
+TEST(ThreadPool, WorkStealingRemove) {
+  ThreadPool tp(1, ThreadPool::Mode::kWorkStealing);
+  std::promise<void> release;
+  auto released = release.get_future().share();
+
+  // keep the only worker busy, so the next messages stay in its deque
+  Message block([](Message& m) { static_cast<std::shared_future<void>*>(m.ptr0)->wait(); },
+                nullptr);
+  block.ptr0 = &released;
+  tp.postMessage(block);
+
+  std::atomic_int64_t i = 0;
+  Message msg(handleMessage, nullptr);
+  msg.ptr0 = &i;
+  auto removed = tp.postMessage(msg);
+  auto kept = tp.postMessage(msg);
+  EXPECT_NE(removed, 0);
+  EXPECT_NE(removed, kept);
+  tp.removeMessage(removed);
+
+  release.set_value();
+  tp.shutdown(true);
+  EXPECT_EQ(1, i.load());
+}
+
+TEST(ThreadPool, TinyTaskBenchmark) {
+  SKIP_UNLESS_BENCHMARK_ENABLED();
+
+  constexpr int64_t kMessageCount = 1000 * 1000;
+  constexpr auto kProducerCount = 4;
+
+  for (auto mode : {ThreadPool::Mode::kSharedQueue, ThreadPool::Mode::kWorkStealing}) {
+    for (size_t workers : {1, 4, 16, 64}) {
+      auto i = std::make_unique<std::atomic_int64_t>();
+      ThreadPool tp(workers, mode);
+
+      auto name = std::string(mode == ThreadPool::Mode::kSharedQueue ? "shared " : "stealing ") +
+                  std::to_string(workers) + "-workers";
+      script::test::runBenchmark(name.c_str(), kMessageCount, [&]() {
+        std::vector<std::thread> producers;
+        for (int p = 0; p < kProducerCount; ++p) {
+          producers.emplace_back([&]() {
+            Message msg(handleMessage, nullptr);
+            msg.ptr0 = i.get();
+            for (int64_t j = 0; j < kMessageCount / kProducerCount; ++j) {
+              tp.postMessage(msg);
+            }
+          });
+        }
+        for (auto& t : producers) {
+          t.join();
+        }
+        tp.shutdown(true);
+      });
+      EXPECT_EQ(kMessageCount, i->load());
+    }
+  }
+}
+
 }  // namespace script::utils::test
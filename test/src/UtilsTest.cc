@@ -15,6 +15,13 @@
  * limitations under the License.
  */
 
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include "test.h"
 
 namespace script::test {
@@ -69,4 +76,346 @@ TEST_F(UtilsTest, Tracer) {
   Tracer::setDelegate(nullptr);
 }
 
+TEST(CodeCacheStore, LruEviction) {
+  auto data = [](size_t size) { return std::make_shared<std::vector<uint8_t>>(size); };
+  utils::LruCodeCacheStore store(100);
+
+  auto a = utils::CodeCacheStore::hash("a");
+  auto b = utils::CodeCacheStore::hash("b");
+  auto c = utils::CodeCacheStore::hash("c");
+  EXPECT_NE(a, b);
+  EXPECT_EQ(a, utils::CodeCacheStore::hash("a"));
+  EXPECT_NE(utils::CodeCacheStore::hash("a", "1.js"), utils::CodeCacheStore::hash("a", "2.js"));
+
+  store.put(a, data(40));
+  store.put(b, data(40));
+  EXPECT_EQ(store.bytes(), 80);
+
+  // touch a, so that b is the least recently used
+  EXPECT_NE(store.get(a), nullptr);
+  store.put(c, data(40));
+  EXPECT_EQ(store.size(), 2);
+  EXPECT_EQ(store.bytes(), 80);
+  EXPECT_EQ(store.get(b), nullptr);
+  EXPECT_NE(store.get(a), nullptr);
+  EXPECT_NE(store.get(c), nullptr);
+
+  // too big to be cached
+  store.put(b, data(101));
+  EXPECT_EQ(store.get(b), nullptr);
+  EXPECT_EQ(store.size(), 2);
+
+  store.remove(a);
+  EXPECT_EQ(store.get(a), nullptr);
+  EXPECT_EQ(store.bytes(), 40);
+
+  store.clear();
+  EXPECT_EQ(store.size(), 0);
+  EXPECT_EQ(store.bytes(), 0);
+}
+
+#ifndef SCRIPTX_BACKEND_WEBASSEMBLY
+
+namespace {
+
+#ifdef SCRIPTX_LANG_JAVASCRIPT
+constexpr auto kPoolBaseScript = "var base = 40; var dirty = false;";
+constexpr auto kPoolUseScript = "dirty = true; base + PoolNative.two();";
+constexpr auto kPoolDirtyScript = "dirty";
+#elif defined(SCRIPTX_LANG_LUA)
+constexpr auto kPoolBaseScript = "base = 40; dirty = false";
+constexpr auto kPoolUseScript = "dirty = true; return base + PoolNative.two()";
+constexpr auto kPoolDirtyScript = "return dirty";
+#endif
+
+const ClassDefine<void> kPoolNative =
+    defineClass("PoolNative").function("two", []() { return Number::newNumber(2); }).build();
+
+utils::EnginePool::Config poolConfig(size_t poolSize) {
+  utils::EnginePool::Config config;
+  config.poolSize = poolSize;
+  config.engineFactory = []() -> ScriptEngine* { return new ScriptEngineImpl(); };
+  config.nativeClasses = {kPoolNative.getNativeRegister()};
+  config.baseScripts = {kPoolBaseScript};
+  config.resetEngine = [](ScriptEngine* engine) {
+    engine->eval("dirty = false");
+    return true;
+  };
+  return config;
+}
+
+}  // namespace
+
+TEST(EnginePool, LeaseAndReset) {
+  utils::EnginePool pool(poolConfig(2));
+  EXPECT_EQ(pool.idleCount(), 2);
+  EXPECT_EQ(pool.statistics().created, 2);
+
+  ScriptEngine* first = nullptr;
+  {
+    auto lease = pool.acquire();
+    first = lease.get();
+    EXPECT_EQ(pool.idleCount(), 1);
+    EXPECT_EQ(pool.leasedCount(), 1);
+
+    EngineScope scope(lease.get());
+    EXPECT_EQ(lease->eval(kPoolUseScript).asNumber().toInt32(), 42);
+  }
+  EXPECT_EQ(pool.idleCount(), 2);
+  EXPECT_EQ(pool.leasedCount(), 0);
+  EXPECT_EQ(pool.statistics().reset, 1);
+
+  {
+    // the reset engine went to the back of the queue
+    auto a = pool.acquire();
+    auto b = pool.acquire();
+    ASSERT_EQ(b.get(), first);
+
+    EngineScope scope(b.get());
+    EXPECT_FALSE(b->eval(kPoolDirtyScript).asBoolean().value());
+
+    // none is idle, a new one is created on demand
+    auto c = pool.acquire();
+    EXPECT_EQ(pool.leasedCount(), 3);
+    EXPECT_EQ(pool.statistics().created, 3);
+  }
+  // the extra engine is dropped
+  auto statistics = pool.statistics();
+  EXPECT_EQ(statistics.idle, 2);
+  EXPECT_EQ(statistics.leased, 0);
+  EXPECT_EQ(statistics.recycled, 0);
+}
+
+TEST(EnginePool, Recycle) {
+  auto config = poolConfig(1);
+  config.maxLeasesPerEngine = 2;
+  config.refillInBackground = false;
+  utils::EnginePool pool(std::move(config));
+
+  pool.acquire();
+  EXPECT_EQ(pool.recycledCount(), 0);
+  pool.acquire();
+  EXPECT_EQ(pool.recycledCount(), 1);
+  // the replacement is not built by the returning thread
+  EXPECT_EQ(pool.idleCount(), 0);
+  EXPECT_EQ(pool.statistics().created, 1);
+
+  {
+    auto lease = pool.acquire();
+    EXPECT_EQ(pool.statistics().created, 2);
+    auto moved = std::move(lease);
+    EXPECT_FALSE(lease);
+    moved.markForRecycle();
+    moved.release();
+    EXPECT_FALSE(moved);
+  }
+  EXPECT_EQ(pool.recycledCount(), 2);
+  EXPECT_EQ(pool.idleCount(), 0);
+
+  pool.prewarm();
+  EXPECT_EQ(pool.idleCount(), 1);
+  EXPECT_EQ(pool.statistics().created, 3);
+}
+
+TEST(EnginePool, BackgroundRefill) {
+  // without resetEngine every returned engine is recycled
+  auto config = poolConfig(1);
+  config.resetEngine = nullptr;
+  utils::EnginePool pool(std::move(config));
+
+  auto awaitIdle = [&pool]() {
+    for (int i = 0; i < 1000 && pool.idleCount() == 0; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return pool.idleCount();
+  };
+
+  for (size_t i = 1; i <= 3; ++i) {
+    ASSERT_EQ(awaitIdle(), 1);
+    // the replacement is already built, acquire() doesn't initialize one
+    auto created = pool.statistics().created;
+    auto lease = pool.acquire();
+    EXPECT_EQ(pool.statistics().created, created);
+
+    EngineScope scope(lease.get());
+    EXPECT_FALSE(lease->eval(kPoolDirtyScript).asBoolean().value());
+    lease->eval(kPoolUseScript);
+  }
+  EXPECT_EQ(awaitIdle(), 1);
+  EXPECT_EQ(pool.recycledCount(), 3);
+  EXPECT_EQ(pool.statistics().created, 4);
+}
+
+TEST(EnginePool, ConcurrentPrewarm) {
+  auto config = poolConfig(2);
+  config.refillInBackground = false;
+  utils::EnginePool pool(std::move(config));
+  {
+    // leave the pool empty
+    auto a = pool.acquire();
+    auto b = pool.acquire();
+    a.markForRecycle();
+    b.markForRecycle();
+  }
+  ASSERT_EQ(pool.idleCount(), 0);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&pool]() { pool.prewarm(); });
+  }
+  for (auto& t : threads) t.join();
+  // engines built by racing threads beyond poolSize are dropped
+  EXPECT_EQ(pool.idleCount(), 2);
+}
+
+TEST(EnginePool, RequireEngineFactory) {
+  auto config = poolConfig(1);
+  config.engineFactory = nullptr;
+  EXPECT_THROW(utils::EnginePool(std::move(config)), std::runtime_error);
+
+  auto nullEngine = poolConfig(1);
+  nullEngine.engineFactory = []() -> ScriptEngine* { return nullptr; };
+  EXPECT_THROW(utils::EnginePool(std::move(nullEngine)), std::runtime_error);
+}
+
+#endif
+
+TEST(ThreadCachingMemoryPool, ObtainRelease) {
+  struct Item {
+    int value = 42;
+  };
+  utils::ThreadCachingMemoryPool<Item> pool(64, true);
+
+  std::vector<Item*> items;
+  for (int i = 0; i < 200; ++i) {
+    items.push_back(pool.obtain());
+    EXPECT_EQ(items.back()->value, 42);
+  }
+  // released ones are reused
+  for (auto item : items) pool.release(item);
+  EXPECT_EQ(pool.obtain(), items.back());
+  pool.release(items.back());
+
+  // obtain on one thread, release on another
+  std::vector<Item*> crossThread;
+  std::thread producer([&]() {
+    for (int i = 0; i < 200; ++i) crossThread.push_back(pool.obtain());
+  });
+  producer.join();
+  for (auto item : crossThread) pool.release(item);
+
+  pool.cleanup();
+  auto item = pool.obtain();
+  EXPECT_NE(item, nullptr);
+  pool.release(item);
+}
+
+TEST(ThreadCachingMemoryPool, Allocator) {
+  std::list<int, utils::ThreadCachingMemoryPool<int>::Allocator<64, false>> list;
+  for (int i = 0; i < 1000; ++i) list.push_back(i);
+  int expected = 0;
+  for (auto i : list) EXPECT_EQ(i, expected++);
+  list.clear();
+  for (int i = 0; i < 1000; ++i) list.push_front(i);
+  EXPECT_EQ(list.front(), 999);
+}
+
+namespace {
+struct CountedItem {
+  static inline std::atomic_int live = 0;
+
+  CountedItem() { live++; }
+
+  ~CountedItem() { live--; }
+};
+}  // namespace
+
+TEST(ThreadCachingMemoryPool, DestructWithLiveThread) {
+  constexpr int kCapacity = 64;
+  constexpr int kObjects = 100;
+  auto pool = std::make_unique<utils::ThreadCachingMemoryPool<CountedItem>>(kCapacity);
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  int step = 0;
+  auto advanceTo = [&](int next) {
+    {
+      std::lock_guard<std::mutex> lk(mutex);
+      step = next;
+    }
+    cv.notify_all();
+  };
+  auto awaitStep = [&](int expected) {
+    std::unique_lock<std::mutex> lk(mutex);
+    cv.wait(lk, [&]() { return step == expected; });
+  };
+
+  std::thread worker([&]() {
+    std::vector<CountedItem*> items;
+    for (int i = 0; i < kObjects; ++i) items.push_back(pool->obtain());
+    // cached in this thread's magazine and the depot
+    for (auto item : items) pool->release(item);
+    advanceTo(1);
+
+    awaitStep(2);
+    {
+      // using any pool drops the magazine of the destructed one
+      utils::ThreadCachingMemoryPool<CountedItem> other(8);
+      other.release(other.obtain());
+    }
+    advanceTo(3);
+  });
+
+  awaitStep(1);
+  // objects beyond the slabs are only kept in the thread's magazine, not in the depot
+  EXPECT_GE(CountedItem::live.load(), kCapacity);
+  EXPECT_LE(CountedItem::live.load(),
+            kCapacity + 2 * internal::ThreadCachingPoolCore::kMagazineSize);
+
+  // the worker is still alive, depot and slabs are freed anyway
+  pool.reset();
+  EXPECT_LE(CountedItem::live.load(), kObjects - kCapacity);
+
+  advanceTo(2);
+  awaitStep(3);
+  EXPECT_EQ(CountedItem::live.load(), 0);
+
+  worker.join();
+}
+
+TEST(ThreadCachingMemoryPool, ContentionBenchmark) {
+  SKIP_UNLESS_BENCHMARK_ENABLED();
+
+  struct Item {
+    int64_t data[8]{};
+  };
+  constexpr int kOperations = 1000000;
+  constexpr int kBatch = 16;
+
+  auto run = [](auto& pool, int threadCount) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+      threads.emplace_back([&pool, threadCount]() {
+        std::vector<Item*> items;
+        items.reserve(kBatch);
+        for (int i = 0; i < kOperations / threadCount / kBatch; ++i) {
+          for (int j = 0; j < kBatch; ++j) items.push_back(pool.obtain());
+          for (auto item : items) pool.release(item);
+          items.clear();
+        }
+      });
+    }
+    for (auto& t : threads) t.join();
+  };
+
+  for (int threadCount : {1, 2, 4, 8}) {
+    utils::MemoryPool<Item> locked(1024);
+    utils::ThreadCachingMemoryPool<Item> caching(1024);
+    auto suffix = " threads: " + std::to_string(threadCount);
+    runBenchmark(("mutex" + suffix).c_str(), kOperations, [&]() { run(locked, threadCount); });
+    runBenchmark(("thread caching" + suffix).c_str(), kOperations,
+                 [&]() { run(caching, threadCount); });
+  }
+}
+
 }  // namespace script::test
\ No newline at end of file
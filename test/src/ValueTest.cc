@@ -140,6 +140,70 @@ TEST_F(ValueTest, Object) {
   }
 }
 
+TEST_F(ValueTest, ObjectInternedKey) {
+  EngineScope engineScope(engine);
+  auto obj = Object::newObject();
+  std::string longKey(100, 'k');
+  for (int i = 0; i < 2000; ++i) {
+    StackFrameScope frame;
+    auto key = "key" + std::to_string(i);
+    obj.set(key, i);
+    obj.set(longKey, i);
+    ASSERT_TRUE(obj.has(key));
+    EXPECT_EQ(obj.get(std::string_view(key)).asNumber().toInt32(), i);
+    EXPECT_EQ(obj.get(longKey).asNumber().toInt32(), i);
+  }
+  obj.remove("key0");
+  EXPECT_FALSE(obj.has("key0"));
+
+  auto key = engine->getInternedKey("hello");
+  EXPECT_EQ(key.toString(), "hello");
+  EXPECT_TRUE(key.asValue() == engine->getInternedKey(std::string("hello")).asValue());
+}
+
+TEST_F(ValueTest, ObjectInternedKeyEviction) {
+  EngineScope engineScope(engine);
+  auto obj = Object::newObject();
+  obj.set("hot", -1);
+  // more distinct keys than the cache holds, the hot key keeps being used in between
+  for (int i = 0; i < 3000; ++i) {
+    StackFrameScope frame;
+    auto key = "churn" + std::to_string(i);
+    obj.set(key, i);
+    EXPECT_EQ(obj.get("hot").asNumber().toInt32(), -1);
+    EXPECT_EQ(engine->getInternedKey(key).toString(), key);
+  }
+  for (int i = 0; i < 3000; i += 100) {
+    EXPECT_EQ(obj.get("churn" + std::to_string(i)).asNumber().toInt32(), i);
+  }
+  EXPECT_TRUE(engine->getInternedKey("hot").asValue() == String::newString("hot").asValue());
+}
+
+TEST_F(ValueTest, ObjectStringKeyBenchmark) {
+  SKIP_UNLESS_BENCHMARK_ENABLED();
+
+  EngineScope engineScope(engine);
+  constexpr int kCount = 1000000;
+  auto obj = Object::newObject();
+  obj.set("hello", 1);
+
+  auto run = [&](const char* name, auto&& access) {
+    runBenchmark(name, kCount, [&]() {
+      for (int i = 0; i < kCount; ++i) {
+        StackFrameScope frame;
+        access();
+      }
+    });
+  };
+
+  auto hoisted = String::newString("hello");
+  static const internal::InternedKey kHello("hello");
+  run("new String key", [&]() { obj.get(String::newString("hello")); });
+  run("hoisted String key", [&]() { obj.get(hoisted); });
+  run("InternedKey", [&]() { obj.get(engine->getInternedKey(kHello)); });
+  run("runtime interned key", [&]() { obj.get("hello"); });
+}
+
 TEST_F(ValueTest, ObjectKeys) {
   EngineScope engineScope(engine);
   auto obj = Object::newObject();
@@ -19,6 +19,11 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+
 #include <ScriptX/ScriptX.h>
 
 #ifndef __cpp_lib_char8_t
@@ -57,6 +62,28 @@ struct TS {
   script::Local<script::Value> script;
 };
 
+// benchmarks are skipped unless built with -DSCRIPTX_TEST_ENABLE_BENCHMARK
+#ifdef SCRIPTX_TEST_ENABLE_BENCHMARK
+constexpr bool kEnableBenchmark = true;
+#else
+constexpr bool kEnableBenchmark = false;
+#endif
+
+/**
+ * time one run of fn which performs ops operations, print and return the cost in ns/op.
+ */
+template <typename Fn>
+double runBenchmark(const char* name, size_t ops, Fn&& fn) {
+  auto start = std::chrono::steady_clock::now();
+  fn();
+  auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start)
+                .count() /
+            static_cast<double>(ops);
+  std::cout << std::left << std::setw(28) << name << std::right << std::setw(12) << ns << " ns/op"
+            << std::endl;
+  return ns;
+}
+
 class ScriptXTestFixture : public testing::Test {
  protected:
   script::ScriptEngine* engine = nullptr;
@@ -71,3 +98,8 @@ class ScriptXTestFixture : public testing::Test {
 
 #define DEFINE_ENGINE_TEST(NAME) \
   class NAME : public ::script::test::ScriptXTestFixture {}
+
+#define SKIP_UNLESS_BENCHMARK_ENABLED()                               \
+  if (!::script::test::kEnableBenchmark) {                            \
+    GTEST_SKIP() << "build with SCRIPTX_TEST_ENABLE_BENCHMARK to run"; \
+  }